@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+# Copyright(c) 2023-2024 Gaoxing Li Distributed under the Apache License 2.0 (http://www.apache.org/licenses/)
+"""Compare an okec_bench JSON result against a stored baseline.
+
+usage: compare.py baseline.json current.json [--threshold 0.10]
+
+Exits with status 1 when any benchmark is slower than the baseline by more
+than the threshold (relative ns/op).
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return {(b["name"], b["size"]): b for b in data["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative slowdown reported as a regression (default: 0.10)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    print(f"{'benchmark':<28} {'size':>10} {'baseline ns/op':>16} {'current ns/op':>16} {'change':>9}")
+    for key in sorted(current):
+        name, size = key
+        now = current[key]["ns_per_op"]
+        if key not in baseline:
+            print(f"{name:<28} {size:>10} {'-':>16} {now:>16.1f} {'new':>9}")
+            continue
+
+        before = baseline[key]["ns_per_op"]
+        change = (now - before) / before if before > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:<28} {size:>10} {before:>16.1f} {now:>16.1f} {change:>+8.1%}{flag}")
+
+    for key in sorted(set(baseline) - set(current)):
+        print(f"{key[0]:<28} {key[1]:>10} {'missing in current run':>43}")
+
+    if regressions:
+        print(f"\n{regressions} regression(s) above {args.threshold:.0%}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
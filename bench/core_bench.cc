@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "harness.hpp"
+#include <okec/okec.hpp>
+
+
+namespace {
+
+auto bench_simulator() -> okec::simulator&
+{
+    // ns-3 global state is set up once per process.
+    static okec::simulator sim;
+    return sim;
+}
+
+auto make_task(std::size_t n) -> okec::task
+{
+    okec::task t;
+    for (std::size_t i = 0; i < n; ++i) {
+        t.emplace_back({
+            { "task_id", okec::task::unique_id() },
+            { "group", "bench" },
+            { "cpu", std::to_string(0.2 + (i % 10) * 0.1) },
+            { "deadline", "10" },
+            { "status", "0" }
+        });
+    }
+    return t;
+}
+
+auto fill_cache(okec::device_cache& cache, std::size_t n) -> void
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        auto ip = okec::format("10.{}.{}.{}", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff);
+        auto cpu = std::to_string(1.0 + (i * 7919 % 1000) / 100.0);
+        cache.emplace_back({
+            { "device_type", "es" },
+            { "ip", ip },
+            { "port", "8860" },
+            { "cpu", cpu },
+            { "pos_x", "0" },
+            { "pos_y", "0" },
+            { "pos_z", "0" }
+        });
+    }
+}
+
+} // namespace
+
+
+OKEC_BENCHMARK("task/emplace_back", okec::bench::decades())
+{
+    state.items_per_iteration(state.size());
+    state.measure([&] {
+        auto t = make_task(state.size());
+        okec::bench::do_not_optimize(t);
+    });
+}
+
+OKEC_BENCHMARK("task/unique_id", { 1 })
+{
+    state.measure([&] {
+        auto id = okec::task::unique_id();
+        okec::bench::do_not_optimize(id);
+    });
+}
+
+OKEC_BENCHMARK("task_element/get_header", okec::bench::decades())
+{
+    auto t = make_task(state.size());
+    auto elements = t.elements_view();
+    std::size_t i{};
+    state.measure([&] {
+        auto value = elements[i++ % elements.size()].get_header("cpu");
+        okec::bench::do_not_optimize(value);
+    });
+}
+
+OKEC_BENCHMARK("task_element/copy", okec::bench::decades())
+{
+    // What a base station does with every queued item.
+    auto t = make_task(state.size());
+    auto elements = t.release_elements();
+    state.items_per_iteration(state.size());
+    state.measure([&] {
+        std::vector<okec::task_element> queue;
+        queue.reserve(elements.size());
+        for (const auto& item : elements)
+            queue.push_back(item);
+        okec::bench::do_not_optimize(queue);
+    });
+}
+
+OKEC_BENCHMARK("message/to_packet", okec::bench::decades())
+{
+    bench_simulator();
+    okec::message msg;
+    msg.type(okec::message_decision);
+    msg.content(make_task(state.size()));
+    state.items_per_iteration(state.size());
+    state.measure([&] {
+        auto packet = msg.to_packet();
+        okec::bench::do_not_optimize(packet);
+    });
+}
+
+OKEC_BENCHMARK("message/from_packet", okec::bench::decades())
+{
+    bench_simulator();
+    okec::message msg;
+    msg.type(okec::message_decision);
+    msg.content(make_task(state.size()));
+    auto packet = msg.to_packet();
+    state.items_per_iteration(state.size());
+    state.measure([&] {
+        auto parsed = okec::message::from_packet(packet);
+        okec::bench::do_not_optimize(parsed);
+    });
+}
+
+OKEC_BENCHMARK("device_cache/find_if", okec::bench::decades())
+{
+    okec::device_cache cache;
+    fill_cache(cache, state.size());
+
+    // The last device: a full scan.
+    auto ip = okec::format("10.{}.{}.{}", ((state.size() - 1) >> 16) & 0xff, ((state.size() - 1) >> 8) & 0xff, (state.size() - 1) & 0xff);
+    state.items_per_iteration(state.size());
+    state.measure([&] {
+        auto it = cache.find_if([&ip](const okec::device_cache::value_type& item) {
+            return item["ip"] == ip;
+        });
+        okec::bench::do_not_optimize(it);
+    });
+}
+
+OKEC_BENCHMARK("device_cache/find", okec::bench::decades())
+{
+    okec::device_cache cache;
+    fill_cache(cache, state.size());
+
+    auto last = state.size() - 1;
+    okec::device_address address{ static_cast<std::uint32_t>(10u << 24 | last), 8860 };
+    state.measure([&] {
+        auto it = cache.find(address);
+        okec::bench::do_not_optimize(it);
+    });
+}
+
+OKEC_BENCHMARK("worst_fit/make_decision", okec::bench::decades())
+{
+    auto& sim = bench_simulator();
+
+    // No edge servers are attached, so nothing goes over the network; the
+    // cache is filled directly.
+    okec::base_station_container base_stations(sim, 1);
+    okec::edge_device_container edge_servers(sim, 0);
+    okec::client_device_container clients(sim, 0);
+    base_stations.connect_device(edge_servers);
+
+    auto engine = std::make_shared<okec::worst_fit_decision_engine>(&clients, &base_stations);
+    fill_cache(engine->cache(), state.size());
+
+    auto t = make_task(64);
+    auto elements = t.elements_view();
+    std::size_t i{};
+    state.items_per_iteration(state.size());
+    state.measure([&] {
+        auto target = engine->make_decision(elements[i++ % elements.size()]);
+        okec::bench::do_not_optimize(target);
+    });
+}
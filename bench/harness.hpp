@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_BENCH_HARNESS_HPP_
+#define OKEC_BENCH_HARNESS_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace okec::bench
+{
+
+// Keeps the optimizer from discarding a benchmarked result.
+template <typename T>
+inline auto do_not_optimize(T const& value) -> void
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+class state
+{
+public:
+    state(std::size_t size, double min_time)
+        : size_{ size }, min_time_{ min_time }
+    {
+    }
+
+    // Problem size of this run: elements, devices...
+    auto size() const -> std::size_t { return size_; }
+
+    // Items processed by one call of the measured operation, for throughput.
+    auto items_per_iteration(std::size_t n) -> void { items_ = n; }
+
+    // Runs `op` repeatedly, doubling the batch until a batch takes at least
+    // the minimum time, and records the time of that batch. Setup belongs
+    // outside of `op`.
+    template <typename Op>
+    auto measure(Op&& op) -> void {
+        using clock = std::chrono::steady_clock;
+
+        std::size_t batch = 1;
+        for (;;) {
+            auto start = clock::now();
+            for (std::size_t i = 0; i < batch; ++i)
+                op();
+            std::chrono::duration<double> elapsed = clock::now() - start;
+
+            if (elapsed.count() >= min_time_ || batch >= (std::size_t{1} << 30)) {
+                iterations_ = batch;
+                seconds_ = elapsed.count();
+                return;
+            }
+
+            batch *= elapsed.count() > min_time_ / 100 ? 2 : 10;
+        }
+    }
+
+    auto iterations() const -> std::size_t { return iterations_; }
+    auto seconds() const -> double { return seconds_; }
+    auto items() const -> std::size_t { return items_; }
+
+private:
+    std::size_t size_;
+    double min_time_;
+    std::size_t items_{ 1 };
+    std::size_t iterations_{};
+    double seconds_{};
+};
+
+struct benchmark
+{
+    std::string name;
+    std::vector<std::size_t> sizes;
+    std::function<void(state&)> fn;
+};
+
+inline auto registry() -> std::vector<benchmark>&
+{
+    static std::vector<benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct registrar
+{
+    registrar(std::string name, std::vector<std::size_t> sizes, std::function<void(state&)> fn) {
+        registry().push_back({ std::move(name), std::move(sizes), std::move(fn) });
+    }
+};
+
+// 10, 100, ..., 1'000'000
+inline auto decades() -> std::vector<std::size_t>
+{
+    return { 10, 100, 1'000, 10'000, 100'000, 1'000'000 };
+}
+
+} // namespace okec::bench
+
+
+#define OKEC_BENCH_CONCAT_IMPL(a, b) a##b
+#define OKEC_BENCH_CONCAT(a, b) OKEC_BENCH_CONCAT_IMPL(a, b)
+
+// OKEC_BENCHMARK("group/name", sizes) { ... state.measure(...); }
+#define OKEC_BENCHMARK(name, sizes)                                                   \
+    static auto OKEC_BENCH_CONCAT(okec_bench_fn_, __LINE__)(okec::bench::state&) -> void; \
+    static okec::bench::registrar OKEC_BENCH_CONCAT(okec_bench_reg_, __LINE__){       \
+        name, sizes, OKEC_BENCH_CONCAT(okec_bench_fn_, __LINE__) };                   \
+    static auto OKEC_BENCH_CONCAT(okec_bench_fn_, __LINE__)(okec::bench::state& state) -> void
+
+#endif // OKEC_BENCH_HARNESS_HPP_
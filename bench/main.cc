@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+// okec_bench [--filter=<substring>] [--max-size=<n>] [--min-time=<seconds>] [--out=<file.json>]
+
+#include "harness.hpp"
+#include <okec/utils/format_helper.hpp>
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <string_view>
+
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string out;
+    std::size_t max_size = 1'000'000;
+    double min_time = 0.2;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{ argv[i] };
+        auto value = [&arg](std::string_view prefix) {
+            return std::string{ arg.substr(prefix.size()) };
+        };
+
+        if (arg.starts_with("--filter="))
+            filter = value("--filter=");
+        else if (arg.starts_with("--max-size="))
+            max_size = std::stoull(value("--max-size="));
+        else if (arg.starts_with("--min-time="))
+            min_time = std::stod(value("--min-time="));
+        else if (arg.starts_with("--out="))
+            out = value("--out=");
+        else {
+            okec::print("usage: {} [--filter=<substring>] [--max-size=<n>] [--min-time=<seconds>] [--out=<file.json>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    nlohmann::json results = nlohmann::json::array();
+    okec::print("{:<28} {:>10} {:>12} {:>16} {:>16}\n", "benchmark", "size", "iterations", "ns/op", "items/s");
+
+    for (auto& bm : okec::bench::registry()) {
+        if (!filter.empty() && bm.name.find(filter) == std::string::npos)
+            continue;
+
+        for (auto size : bm.sizes) {
+            if (size > max_size)
+                continue;
+
+            okec::bench::state state{ size, min_time };
+            bm.fn(state);
+            if (!state.iterations())
+                continue;
+
+            double ns_per_op = state.seconds() * 1e9 / state.iterations();
+            double items_per_second = state.items() * state.iterations() / state.seconds();
+            okec::print("{:<28} {:>10} {:>12} {:>16.1f} {:>16.0f}\n", bm.name, size, state.iterations(), ns_per_op, items_per_second);
+
+            results.push_back({
+                { "name", bm.name },
+                { "size", size },
+                { "iterations", state.iterations() },
+                { "ns_per_op", ns_per_op },
+                { "items_per_second", items_per_second }
+            });
+        }
+    }
+
+    if (!out.empty()) {
+        std::ofstream file{ out };
+        if (!file) {
+            okec::print("cannot write {}\n", out);
+            return 1;
+        }
+        file << nlohmann::json{ { "version", 1 }, { "benchmarks", results } }.dump(2) << '\n';
+    }
+
+    return 0;
+}
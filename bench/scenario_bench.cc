@@ -0,0 +1,280 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+// End-to-end scenario benchmark. One run per process, so peak RSS and the
+// ns-3 event count belong to that scenario only.
+//
+// okec_scenario_bench [--engine=wf|cee] [--edges=<n>] [--clients=<n>] [--tasks=<n>]
+//                     [--stop=<seconds>] [--seed=<n>] [--out=<file.json>]
+
+#include <okec/okec.hpp>
+#include <nlohmann/json.hpp>
+#include <sys/resource.h>
+#include <chrono>
+#include <fstream>
+#include <string_view>
+
+
+namespace {
+
+// The LAN and WLAN segments of the network models are /24 networks.
+constexpr std::size_t devices_per_segment = 200;
+
+struct options
+{
+    std::string engine = "wf";
+    std::size_t edges = 10;
+    std::size_t clients = 10;
+    std::size_t tasks = 1'000;
+    double stop = .0; // 0: derived from the launch schedule of the engine
+    unsigned seed = 1;
+    std::string out;
+};
+
+using clock = std::chrono::steady_clock;
+
+struct counters
+{
+    clock::time_point setup_end;
+    std::uint64_t packets_sent{};
+    std::size_t edges{};   // as built, at least one per base station
+    std::size_t clients{};
+};
+
+auto peak_rss_kb() -> long
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // kilobytes on Linux
+}
+
+auto count_packets(counters& c) -> void
+{
+    ns3::Config::ConnectWithoutContextFailSafe("/NodeList/*/$ns3::Ipv4L3Protocol/Tx",
+        ns3::MakeBoundCallback(+[](counters* c, ns3::Ptr<const ns3::Packet>, ns3::Ptr<ns3::Ipv4>, uint32_t) {
+            ++c->packets_sent;
+        }, &c));
+}
+
+// Runs the simulation while the devices of the scenario are still alive.
+auto run(okec::simulator& sim, counters& c) -> void
+{
+    count_packets(c);
+    c.setup_end = clock::now();
+    sim.run();
+}
+
+auto make_tasks(std::size_t n, std::string_view group) -> okec::task
+{
+    okec::task t;
+    for (std::size_t i = 0; i < n; ++i) {
+        t.emplace_back({
+            { "task_id", okec::task::unique_id() },
+            { "group", std::string{ group } },
+            { "cpu", okec::rand_range(0.2, 1.2).to_string() },
+            { "size", okec::rand_range(0.5, 2.0).to_string() },
+            { "deadline", okec::rand_range(10, 100).to_string() }
+        });
+    }
+    return t;
+}
+
+auto install_edge_resources(okec::edge_device_container& edges) -> void
+{
+    okec::resource_container resources(edges.size());
+    resources.initialize([](auto res) {
+        res->attribute("cpu", okec::rand_range(2.1, 2.2).to_string());
+    });
+    edges.install_resources(resources);
+}
+
+// Splits `total` as evenly as possible into `parts`.
+auto share(std::size_t total, std::size_t parts, std::size_t index) -> std::size_t
+{
+    return total / parts + (index < total % parts ? 1 : 0);
+}
+
+// Sends the tasks round-robin from the clients.
+auto launch(auto& clients, std::size_t tasks) -> void
+{
+    std::size_t n = clients.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        auto count = share(tasks, n, i);
+        if (count)
+            clients[i]->send(make_tasks(count, okec::format("client-{}", i)));
+    }
+}
+
+// Base stations are added so that no LAN or WLAN segment overflows.
+auto station_count(const options& opts) -> std::size_t
+{
+    return std::max<std::size_t>(1,
+        (std::max(opts.edges, opts.clients) + devices_per_segment - 1) / devices_per_segment);
+}
+
+// One edge and one client group per base station.
+auto make_groups(okec::simulator& sim, const options& opts, okec::base_station_container& base_stations,
+    std::vector<okec::edge_device_container>& edges, std::vector<okec::client_device_container>& clients, counters& c) -> void
+{
+    std::size_t stations = base_stations.size();
+    edges.reserve(stations);   // base stations keep pointers to their edge servers
+    clients.reserve(stations);
+    for (std::size_t i = 0; i < stations; ++i) {
+        edges.emplace_back(sim, std::max<std::size_t>(1, share(opts.edges, stations, i)));
+        clients.emplace_back(sim, std::max<std::size_t>(1, share(opts.clients, stations, i)));
+        base_stations[i]->connect_device(edges[i]);
+        c.edges += edges[i].size();
+        c.clients += clients[i].size();
+    }
+}
+
+auto all_clients(std::vector<okec::client_device_container>& clients) -> std::vector<std::shared_ptr<okec::client_device>>
+{
+    std::vector<std::shared_ptr<okec::client_device>> senders;
+    for (auto& group : clients)
+        for (std::size_t i = 0; i < group.size(); ++i)
+            senders.push_back(group.get_device(i));
+    return senders;
+}
+
+// worst_fit_decision_engine over multiple_and_single_LAN_WLAN_network_model.
+auto worst_fit_scenario(okec::simulator& sim, const options& opts, counters& c) -> void
+{
+    okec::base_station_container base_stations(sim, station_count(opts));
+    std::vector<okec::edge_device_container> edges;
+    std::vector<okec::client_device_container> clients;
+    make_groups(sim, opts, base_stations, edges, clients, c);
+
+    okec::multiple_and_single_LAN_WLAN_network_model model;
+    okec::network_initializer(model, clients, base_stations);
+
+    for (auto& group : edges)
+        install_edge_resources(group);
+
+    auto engine = std::make_shared<okec::worst_fit_decision_engine>(&clients, &base_stations);
+    engine->initialize();
+
+    launch(all_clients(clients), opts.tasks);
+    run(sim, c);
+}
+
+// cloud_edge_end_default_decision_engine over cloud_edge_end_model, with the
+// clients writing their requests to the network.
+auto cloud_edge_end_scenario(okec::simulator& sim, const options& opts, counters& c) -> void
+{
+    okec::base_station_container base_stations(sim, station_count(opts));
+    std::vector<okec::edge_device_container> edges;
+    std::vector<okec::client_device_container> clients;
+    make_groups(sim, opts, base_stations, edges, clients, c);
+    okec::cloud_server cloud(sim);
+
+    okec::cloud_edge_end_model model;
+    okec::network_initializer(model, clients, base_stations, cloud);
+
+    for (auto& group : edges)
+        install_edge_resources(group);
+    auto cloud_res = okec::make_resource();
+    cloud_res->attribute("cpu", "20");
+    cloud.install_resource(cloud_res);
+
+    auto engine = std::make_shared<okec::cloud_edge_end_default_decision_engine>(&clients, &base_stations, &cloud);
+    engine->network_dispatch(true);
+    engine->initialize();
+
+    launch(all_clients(clients), opts.tasks);
+    run(sim, c);
+}
+
+auto parse(int argc, char** argv, options& opts) -> bool
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{ argv[i] };
+        auto value = [&arg](std::string_view prefix) {
+            return std::string{ arg.substr(prefix.size()) };
+        };
+
+        if (arg.starts_with("--engine="))
+            opts.engine = value("--engine=");
+        else if (arg.starts_with("--edges="))
+            opts.edges = std::stoull(value("--edges="));
+        else if (arg.starts_with("--clients="))
+            opts.clients = std::stoull(value("--clients="));
+        else if (arg.starts_with("--tasks="))
+            opts.tasks = std::stoull(value("--tasks="));
+        else if (arg.starts_with("--stop="))
+            opts.stop = std::stod(value("--stop="));
+        else if (arg.starts_with("--seed="))
+            opts.seed = std::stoul(value("--seed="));
+        else if (arg.starts_with("--out="))
+            opts.out = value("--out=");
+        else
+            return false;
+    }
+
+    return opts.engine == "wf" || opts.engine == "cee";
+}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+    options opts;
+    if (!parse(argc, argv, opts)) {
+        okec::print("usage: {} [--engine=wf|cee] [--edges=<n>] [--clients=<n>] [--tasks=<n>] "
+                    "[--stop=<seconds>] [--seed=<n>] [--out=<file.json>]\n", argv[0]);
+        return 1;
+    }
+
+    ns3::RngSeedManager::SetSeed(opts.seed);
+
+    // The engines launch one task every 10ms (worst fit) or every second
+    // (cloud-edge-end); leave room for the last ones to finish.
+    double stop = opts.stop > 0 ? opts.stop
+        : (opts.engine == "wf" ? 0.3 + opts.tasks * 0.01 : opts.tasks * 1.0) + 60.0;
+
+    auto begin = clock::now();
+
+    okec::simulator sim(ns3::Seconds(stop));
+    counters c;
+    if (opts.engine == "wf")
+        worst_fit_scenario(sim, opts, c);
+    else
+        cloud_edge_end_scenario(sim, opts, c);
+
+    auto end = clock::now();
+
+    std::chrono::duration<double> setup_time = c.setup_end - begin;
+    std::chrono::duration<double> run_time = end - c.setup_end;
+    auto events = ns3::Simulator::GetEventCount();
+
+    nlohmann::json result {
+        { "engine", opts.engine },
+        { "edges", c.edges },
+        { "clients", c.clients },
+        { "tasks", opts.tasks },
+        { "simulated_seconds", stop },
+        { "setup_seconds", setup_time.count() },
+        { "run_seconds", run_time.count() },
+        { "wall_seconds", setup_time.count() + run_time.count() },
+        { "events", events },
+        { "events_per_second", run_time.count() > 0 ? events / run_time.count() : .0 },
+        { "peak_rss_kb", peak_rss_kb() },
+        { "packets_sent", c.packets_sent }
+    };
+
+    okec::print("{}\n", result.dump(2));
+    if (!opts.out.empty()) {
+        std::ofstream file{ opts.out, std::ios::app };
+        file << result.dump() << '\n';
+    }
+
+    return 0;
+}
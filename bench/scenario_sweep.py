@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+# Copyright(c) 2023-2024 Gaoxing Li Distributed under the Apache License 2.0 (http://www.apache.org/licenses/)
+"""Run okec_scenario_bench over a grid of sizes and collect a scaling curve.
+
+usage: scenario_sweep.py path/to/okec_scenario_bench [--engine wf|cee|all]
+                         [--preset quick|full] [--out results.jsonl]
+
+Each configuration runs in its own process. Results are appended to the
+output file as JSON lines and summarized as a table, with the growth of wall
+time per task between consecutive sizes to spot super-linear behavior.
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+
+PRESETS = {
+    # (edges, clients, tasks)
+    "quick": [
+        (10, 10, 1_000),
+        (100, 100, 10_000),
+    ],
+    "full": [
+        (10, 10, 1_000),
+        (100, 100, 10_000),
+        (500, 1_000, 100_000),
+        (1_000, 5_000, 500_000),
+        (5_000, 10_000, 1_000_000),
+    ],
+}
+
+
+def run(binary, engine, edges, clients, tasks, out):
+    cmd = [binary, f"--engine={engine}", f"--edges={edges}", f"--clients={clients}",
+           f"--tasks={tasks}", f"--out={out}"]
+    print("running:", " ".join(cmd), flush=True)
+    proc = subprocess.run(cmd, capture_output=True, text=True)
+    if proc.returncode != 0:
+        print(proc.stdout + proc.stderr, file=sys.stderr)
+        return None
+    # The last JSON object printed is the result.
+    return json.loads(proc.stdout[proc.stdout.rindex("{\n"):])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("binary")
+    parser.add_argument("--engine", default="all", choices=["wf", "cee", "all"])
+    parser.add_argument("--preset", default="quick", choices=sorted(PRESETS))
+    parser.add_argument("--out", default="scenario_results.jsonl")
+    args = parser.parse_args()
+
+    engines = ["wf", "cee"] if args.engine == "all" else [args.engine]
+    failed = 0
+    for engine in engines:
+        rows = []
+        for edges, clients, tasks in PRESETS[args.preset]:
+            result = run(args.binary, engine, edges, clients, tasks, args.out)
+            if result is None:
+                failed += 1
+                continue
+            rows.append(result)
+
+        print(f"\n{engine}: {'edges':>6} {'clients':>8} {'tasks':>9} {'wall s':>9} "
+              f"{'events/s':>12} {'rss MB':>8} {'packets':>10} {'us/task':>9} {'growth':>7}")
+        previous = None
+        for r in rows:
+            per_task = r["wall_seconds"] / r["tasks"] * 1e6
+            growth = f"{per_task / previous:.2f}x" if previous else "-"
+            previous = per_task
+            print(f"{'':>{len(engine) + 1}} {r['edges']:>6} {r['clients']:>8} {r['tasks']:>9} "
+                  f"{r['wall_seconds']:>9.2f} {r['events_per_second']:>12.0f} "
+                  f"{r['peak_rss_kb'] / 1024:>8.1f} {r['packets_sent']:>10} {per_task:>9.1f} {growth:>7}")
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -2,6 +2,7 @@
 #define OKEC_CLOUD_EDGE_END_DEFAULT_DECISION_ENGINE_H_
 
 #include <okec/algorithms/decision_engine.h>
+#include <okec/utils/metrics.h>
 
 
 namespace okec
@@ -20,6 +21,7 @@ class cloud_edge_end_default_decision_engine : public decision_engine
 public:
     cloud_edge_end_default_decision_engine() = default;
     cloud_edge_end_default_decision_engine(client_device_container* clients, base_station_container* base_stations, cloud_server* cloud);
+    cloud_edge_end_default_decision_engine(std::vector<client_device_container>* clients_container, base_station_container* base_stations, cloud_server* cloud);
 
     auto make_decision(const task_element& header) -> result_t override;
 
@@ -33,6 +35,9 @@ public:
 
     auto handle_next() -> void override;
 
+    // 客户端是否真正将决策请求写入网络。默认关闭，此时 send() 只估算上行传输时延
+    auto network_dispatch(bool enabled) -> void;
+
 private:
     auto on_bs_decision_message(base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
 
@@ -48,6 +53,8 @@ private:
     client_device_container* clients_{};
     std::vector<client_device_container>* clients_container_{};
     base_station_container* base_stations_{};
+    bool network_dispatch_{};
+    engine_metrics metric_series_{ "cloud_edge_end" };
 };
 
 
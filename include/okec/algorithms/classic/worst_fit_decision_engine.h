@@ -12,6 +12,7 @@
 #define OKEC_WORST_FIT_DECISION_ENGINE_H_
 
 #include <okec/algorithms/decision_engine.h>
+#include <okec/utils/metrics.h>
 
 
 namespace okec
@@ -33,12 +34,16 @@ public:
 
     auto when_done(done_callback_t callback) -> void;
 
+    // Records the cpu of the cached servers to `tracer`; nothing is traced without one.
+    auto set_tracer(std::shared_ptr<resource_tracer> tracer) -> void;
     auto trace_resource() -> void;
 
 private:
     task t_;
     device_cache cache_;
+    std::shared_ptr<resource_tracer> tracer_;
     std::vector<double> state_; // 初始状态
+    std::vector<double> traced_cpu_; // 上次记录的 cpu
     done_callback_t done_fn_;
 };
 
@@ -62,9 +67,18 @@ public:
 
     auto handle_next() -> void override;
 
+    // Place all pending tasks per handle_next call instead of only the first one.
+    // Each placement is debited from a copy of the cache supplies, so one batch
+    // never overcommits a server.
+    auto batch_mode(bool enabled) -> void;
+
     auto train(const task& t) -> void;
 
 private:
+    auto handle_batch() -> void;
+    auto dispatch(task_element& item, const result_t& target) -> void;
+    auto record_dispatch(const task_element& item) -> void;
+
     auto on_bs_decision_message(base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
 
     auto on_bs_response_message(base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
@@ -77,6 +91,8 @@ private:
     client_device_container* clients_{};
     std::vector<client_device_container>* clients_container_{};
     base_station_container* base_stations_{};
+    bool batch_mode_{};
+    engine_metrics metric_series_{ "worst_fit" };
 };
 
 
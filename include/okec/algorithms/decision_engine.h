@@ -12,8 +12,17 @@
 #define OKEC_DECISION_ENGINE_H_
 
 #include <okec/common/task.h>
+#include <okec/common/device_address.h>
+#include <okec/common/path_table.h>
 #include <okec/common/resource.h>
+#include <okec/common/resource_schema.h>
+#include <okec/network/udp_application.h>
 #include <okec/utils/packet_helper.h>
+#include <ns3/mobility-model.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 
 namespace okec
@@ -24,6 +33,8 @@ class base_station_container;
 class client_device;
 class edge_device;
 class cloud_server;
+class message;
+class spatial_index;
 
 
 class device_cache
@@ -31,9 +42,9 @@ class device_cache
 public:
     using attribute_type   = std::pair<std::string_view, std::string_view>;
     using attributes_type  = std::initializer_list<attribute_type>;
-    using value_type       = json;
-    using iterator         = json::iterator;
-    using const_iterator   = json::const_iterator;
+    using value_type       = arena_json;
+    using iterator         = arena_json::iterator;
+    using const_iterator   = arena_json::const_iterator;
     using unary_predicate_type  = std::function<bool(const value_type&)>;
     using binary_predicate_type = std::function<bool(const value_type&, const value_type&)>;
 
@@ -42,8 +53,8 @@ public:
     auto begin() -> iterator;
     auto end() -> iterator;
 
-    auto cbegin() const -> json::const_iterator;
-    auto cend() const -> json::const_iterator;
+    auto cbegin() const -> const_iterator;
+    auto cend() const -> const_iterator;
 
     auto dump(int indent = -1) const -> std::string;
 
@@ -59,13 +70,40 @@ public:
 
     auto find_if(unary_predicate_type pred) -> iterator;
 
+    // The first item whose "ip" and "port" are `address`, or end(). Served
+    // from an index kept in step with the rows.
+    auto find(device_address address) -> iterator;
+
+    // The "ip" and "port" of an item, or of a decision result.
+    static auto address_of(const value_type& item) -> device_address;
+    static auto address_of(const json& item) -> device_address;
+
     auto sort(binary_predicate_type comp) -> void;
 
+    // Supplies of the items along the resource_schema dimensions, refreshed
+    // lazily. Cloud servers are disabled rows. Writes made through view() or an
+    // iterator must be reported with touch() to show up here.
+    auto matrix() -> const resource_matrix&;
+
+    auto touch(iterator it) -> void;
+    auto touch_all() -> void;
+
+    // Bumped whenever rows are added or reordered.
+    auto generation() const -> std::size_t;
+
 private:
     auto emplace_back(value_type item) -> void;
+    auto rebuild_index() -> void;
 
 private:
     value_type cache;
+    resource_matrix matrix_;
+    std::vector<std::size_t> touched_;
+    bool rebuild_{ true };
+    std::size_t schema_generation_{};
+    std::size_t generation_{};
+    std::unordered_map<device_address, std::size_t> index_; // [address, row]
+    std::size_t index_generation_{ static_cast<std::size_t>(-1) };
 };
 
 
@@ -85,12 +123,36 @@ protected:
     auto resource_changed(edge_device* es, ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void;
     auto conflict(edge_device* es, const task_element& item, ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void;
 
+    // Answers the client of `item` with a failure response (device_type "null").
+    auto reject(base_station* bs, const task_element& item) -> void;
+
+    // Carries the logical user of `item` (see client_population) over to its response.
+    static auto copy_user_id(const task_element& item, message& response) -> void;
+
+    // Whether `item` was sent through a client_population. Its response goes to
+    // the population only; the carrier's response cache keeps no row for it.
+    static auto from_population(const task_element& item) -> bool;
+    static auto from_population(message& response) -> bool;
+
+    // Where responses for `item` go: its from_ip and from_port headers.
+    static auto reply_address(const task_element& item) -> device_address;
+
+    // The base station `client` uploads to: its serving cell when a spatial
+    // index is set, the decision device otherwise.
+    auto uplink_for(const client_device* client) const -> std::shared_ptr<base_station>;
+
 public:
-    virtual ~decision_engine() {}
+    virtual ~decision_engine();
 
     auto calculate_distance(const ns3::Vector& pos) -> double;
     auto calculate_distance(double x, double y, double z) -> double;
 
+    // Distances and delays from the decision device to the cached devices, rows
+    // matching the cache. Rebuilt when the cache gains or reorders rows, and
+    // updated in place when a tracked device changes course. Devices moving at
+    // a constant velocity are re-read from their mobility model on each use.
+    auto paths() -> const path_table&;
+
     auto initialize_device(base_station_container* bs_container, cloud_server* cs) -> void;
     auto initialize_device(base_station_container* bs_container) -> void;
     
@@ -104,12 +166,84 @@ public:
 
     virtual auto handle_next() -> void = 0;
 
+    // State a checkpoint carries besides the device cache and the queues,
+    // such as a learned model. Nothing by default.
+    virtual auto save_state(json& state) const -> void;
+    virtual auto restore_state(const json& state) -> void;
+
     auto get_decision_device() const -> std::shared_ptr<base_station>;
 
     auto cache() -> device_cache&;
 
+    // Coalesce resource_changed notifications into digests. Each edge server
+    // publishes at most one digest per `interval`, carrying only the attributes
+    // that changed since its last digest. A relative change larger than
+    // `threshold` on any numeric attribute publishes immediately.
+    // A zero interval (the default) publishes on every change.
+    auto set_resource_digest(ns3::Time interval, double threshold = .0) -> void;
+
+    // [resource changes reported by edge servers, digests actually sent]
+    auto resource_digest_stats() const -> std::pair<std::size_t, std::size_t>;
+
+    // Uploads go to each client's nearest base station. Queueing and decisions
+    // stay on the decision device.
+    auto set_spatial_index(std::shared_ptr<spatial_index> index) -> void;
+    auto get_spatial_index() const -> std::shared_ptr<spatial_index>;
+
+    // How place() ranks the edge servers that can hold a task. Worst fit by default.
+    auto set_placement_policy(placement_policy policy) -> void;
+    auto get_placement_policy() const -> placement_policy;
+
+protected:
+    // The edge server in the cache able to hold `demand` on every resource_schema
+    // dimension, picked by the placement policy; cache().end() if none can.
+    auto place(const task_element& item) -> device_cache::iterator;
+    auto place(const resource_schema::vector_type& demand) -> device_cache::iterator;
+
+    // Debits the schema dimensions other than cpu, which the engines account for
+    // themselves, from `res`. Nothing is debited and false is returned when one
+    // of them does not fit.
+    auto reserve_dimensions(resource& res, const task_element& item) -> bool;
+    auto release_dimensions(resource& res, const task_element& item) -> void;
+
+private:
+    // Holds what it needs of the edge server by reference count, so a pending
+    // flush never reaches back into a device that has been removed.
+    struct resource_digest {
+        json published;       // attributes last published to the decision device
+        ns3::EventId pending; // scheduled flush, if any
+        ns3::Ptr<resource> source;
+        ns3::Ptr<udp_application> sender;
+    };
+
+    auto publish_digest(device_address address, ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void;
+
+    // Follows the CourseChange of `node`; the zero address marks the decision device.
+    auto track_mobility(ns3::Ptr<ns3::Node> node, device_address address) -> void;
+    static auto on_course_change(decision_engine* self, device_address address, ns3::Ptr<const ns3::MobilityModel> mobility) -> void;
+
+    // Keeps `mobility` in the moving set while its velocity is not zero.
+    auto update_moving(device_address address, ns3::Ptr<const ns3::MobilityModel> mobility) -> void;
+
+    // Brings the positions of the moving devices up to the current time.
+    auto refresh_moving() -> void;
+
 private:
     device_cache m_device_cache;
+    placement_policy m_placement_policy{ placement_policy::worst_fit };
+    path_table m_paths;
+    std::shared_ptr<spatial_index> m_spatial_index;
+    std::size_t m_paths_generation{ static_cast<std::size_t>(-1) };
+    std::unordered_set<uint32_t> m_tracked_nodes;
+    // CourseChange callbacks bound to this engine, disconnected on destruction
+    std::vector<std::pair<ns3::Ptr<ns3::MobilityModel>, ns3::Callback<void, ns3::Ptr<const ns3::MobilityModel>>>> m_course_traces;
+    std::unordered_map<device_address, ns3::Ptr<const ns3::MobilityModel>> m_moving;
+    ns3::Time m_moving_refreshed{ -1 };
+    ns3::Time m_digest_interval{};
+    double m_digest_threshold{};
+    std::size_t m_digest_changes{};
+    std::size_t m_digest_sent{};
+    std::unordered_map<device_address, resource_digest> m_digests;
     std::pair<ns3::Ipv4Address, uint16_t> m_cs_address;
     std::tuple<ns3::Ipv4Address, uint16_t, ns3::Vector> m_cs_info;
 };
@@ -44,6 +44,8 @@ public:
 
     auto learn(std::size_t step) -> void;
 
+    // Records the cpu of the cached servers to `tracer`; nothing is traced without one.
+    auto set_tracer(std::shared_ptr<resource_tracer> tracer) -> void;
     auto trace_resource(int flag = 0) -> void;
 
     int episode;
@@ -52,8 +54,10 @@ private:
     task t_;
     device_cache cache_;
     std::shared_ptr<DeepQNetwork> RL_;
+    std::shared_ptr<resource_tracer> tracer_;
     std::size_t step_;
     std::vector<double> state_; // 初始状态
+    std::vector<double> traced_cpu_; // 上次记录的 cpu
     torch::Tensor observation_;
     done_callback_t done_fn_;
 };
@@ -80,6 +84,10 @@ public:
 
     auto handle_next() -> void override;
 
+    // The networks, the optimizer and the replay memory, when trained.
+    auto save_state(json& state) const -> void override;
+    auto restore_state(const json& state) -> void override;
+
 private:
     auto on_bs_decision_message(base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
 
@@ -94,6 +102,8 @@ private:
     // episode: current episode_all: total episode
     auto train_start(const task& train_task, int episode, int episode_all) -> void;
 
+    auto make_network() -> std::shared_ptr<DeepQNetwork>;
+
 private:
     client_device_container* clients_{};
     std::vector<client_device_container>* clients_container_{};
@@ -101,6 +111,7 @@ private:
 
     std::shared_ptr<DeepQNetwork> RL;
     std::vector<double> total_times_;
+    std::shared_ptr<resource_tracer> tracer_; // one trace across all episodes of a train() call
 };
 
 
@@ -177,6 +177,42 @@ public:
         // std::cout << "Q Table:" << std::endl;
         // std::cout << q_table << std::endl;
     }
+
+    // Everything learning continues from: both networks, the optimizer, the
+    // replay memory and the counters. The shape must match on load.
+    void save(torch::serialize::OutputArchive& archive) const override {
+        torch::serialize::OutputArchive eval_archive, target_archive, optimizer_archive;
+        eval_net.save(eval_archive);
+        target_net.save(target_archive);
+        optimizer.save(optimizer_archive);
+        archive.write("eval_net", eval_archive);
+        archive.write("target_net", target_archive);
+        archive.write("optimizer", optimizer_archive);
+        archive.write("memory", memory);
+        archive.write("epsilon", torch::tensor({epsilon}, torch::kFloat64));
+        archive.write("counters", torch::tensor({learn_step_counter, memory_counter}, torch::kInt64));
+    }
+
+    void load(torch::serialize::InputArchive& archive) override {
+        torch::serialize::InputArchive eval_archive, target_archive, optimizer_archive;
+        archive.read("eval_net", eval_archive);
+        archive.read("target_net", target_archive);
+        archive.read("optimizer", optimizer_archive);
+        eval_net.load(eval_archive);
+        target_net.load(target_archive);
+        optimizer.load(optimizer_archive);
+
+        torch::Tensor saved_memory, saved_epsilon, counters;
+        archive.read("memory", saved_memory);
+        archive.read("epsilon", saved_epsilon);
+        archive.read("counters", counters);
+        if (saved_memory.sizes() != memory.sizes())
+            throw std::runtime_error("replay memory shape mismatch");
+        memory = saved_memory;
+        epsilon = saved_epsilon.item<double>();
+        learn_step_counter = counters[0].item<int>();
+        memory_counter = counters[1].item<int>();
+    }
     
 private:
     int n_actions;
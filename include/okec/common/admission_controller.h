@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_ADMISSION_CONTROLLER_H_
+#define OKEC_ADMISSION_CONTROLLER_H_
+
+#include <okec/common/task.h>
+#include <cstddef>
+#include <optional>
+
+
+namespace okec
+{
+
+struct admission_config
+{
+    // Tasks arriving at a queue this long are dropped. 0 means unbounded.
+    std::size_t max_queue_length = 0;
+
+    // Tasks whose remaining deadline (arrival_time + deadline - now) falls
+    // below this many seconds are dropped. Tasks without a deadline never are.
+    double min_deadline_slack = .0;
+
+    // A task that cannot be placed is retried after
+    // retry_delay * backoff_factor^n seconds, n being its previous retries.
+    double retry_delay = .5;
+    double backoff_factor = 2.0;
+
+    // Retries before the task is dropped. 0 means unbounded.
+    std::size_t max_retries = 0;
+};
+
+
+// Decides whether the decision device accepts a task, and what happens to a
+// task no device can take: wait a while and retry, or give up.
+class admission_controller
+{
+public:
+    admission_controller(admission_config config = {});
+
+    // Called once per arriving task.
+    auto admit(const task_element& item, std::size_t queue_length) -> bool;
+
+    // Called when no device can take `item`. Returns the delay until the next
+    // attempt, or nothing if the task should be dropped. Repeated calls before
+    // the retry is due return the time left without counting a new retry.
+    auto defer(task_element& item) -> std::optional<double>;
+
+    auto config() const -> const admission_config&;
+
+    auto admitted() const -> std::size_t;
+    auto deferred() const -> std::size_t;
+    auto dropped() const -> std::size_t;
+
+private:
+    auto deadline_slack(const task_element& item) const -> std::optional<double>;
+
+private:
+    admission_config config_;
+    std::size_t admitted_{};
+    std::size_t deferred_{};
+    std::size_t dropped_{};
+};
+
+
+} // namespace okec
+
+#endif // OKEC_ADMISSION_CONTROLLER_H_
@@ -11,6 +11,7 @@
 #ifndef OKEC_AWAITABLE_H_
 #define OKEC_AWAITABLE_H_
 
+#include <okec/common/device_address.h>
 #include <okec/common/response.h>
 #include <coroutine>
 
@@ -58,14 +59,14 @@ private:
 
 class response_awaiter {
 public:
-    response_awaiter(simulator& sim, std::string client_address);
+    response_awaiter(simulator& sim, device_address client_address);
     auto await_ready() noexcept -> bool;
     auto await_suspend(std::coroutine_handle<> handle) noexcept -> void;
     [[nodiscard]] auto await_resume() noexcept -> response;
 
 private:
     simulator& sim;
-    std::string client_address;
+    device_address client_address;
     response r;
 };
 
@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_CHECKPOINT_H_
+#define OKEC_CHECKPOINT_H_
+
+#include <okec/algorithms/decision_engine.h>
+#include <okec/devices/base_station.h>
+#include <okec/devices/client_device.h>
+#include <okec/devices/cloud_server.h>
+#include <ns3/nstime.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace okec
+{
+
+class scenario;
+
+struct checkpoint_options {
+    // The state the decision engine reports through save_state().
+    bool engine_state = true;
+};
+
+// Binary snapshot of a simulation: the device cache, the task queues of the
+// base stations, device resources, client responses, the random states and,
+// optionally, what the decision engine learned.
+//
+// Restoring rebuilds nothing; build the same scenario, initialize the decision
+// engine, install resources, then call restore() before simulator::run(). The
+// run continues from the saved time, with now:: reporting okec time.
+//
+// Not captured: pending ns-3 events and packets in flight. Tasks dispatched
+// but not yet answered would have no completion after a restore, so saving
+// is refused while there are any. ns-3 random streams that already exist are not
+// rewound; only the global seed and run number are restored.
+class checkpoint
+{
+public:
+    checkpoint(std::shared_ptr<decision_engine> engine, base_station_container& base_stations);
+
+    // Covers the base stations, clients and cloud of the scenario.
+    checkpoint(std::shared_ptr<decision_engine> engine, scenario& s);
+
+    auto add_clients(client_device_container& clients) -> void;
+    auto add_cloud(cloud_server& cloud) -> void;
+
+    // Saves the state at the current simulated time. Fails if any queued task
+    // has been dispatched and not answered yet.
+    auto save(const std::string& file, checkpoint_options opts = {}) const -> bool;
+
+    // Saves once the simulation reaches `time`, or as soon after as no task is
+    // in flight. The checkpoint must outlive the run.
+    auto save_at(ns3::Time time, std::string file, checkpoint_options opts = {}) -> void;
+
+    auto restore(const std::string& file) -> bool;
+
+private:
+    auto restore_resources(const json& items) const -> void;
+
+    auto save_when_idle(std::string file, checkpoint_options opts) -> void;
+
+    // Queued tasks that were dispatched and await their response.
+    auto in_flight() const -> std::size_t;
+
+private:
+    std::shared_ptr<decision_engine> engine_;
+    base_station_container& base_stations_;
+    std::vector<client_device_container*> clients_;
+    cloud_server* cloud_{};
+};
+
+
+} // namespace okec
+
+#endif // OKEC_CHECKPOINT_H_
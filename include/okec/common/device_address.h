@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_DEVICE_ADDRESS_H_
+#define OKEC_DEVICE_ADDRESS_H_
+
+#include <ns3/ipv4-address.h>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+
+namespace okec
+{
+
+// The IPv4 address and port of a device, kept as integers for keys and
+// comparisons. Dotted-quad text is only produced for messages and output.
+// Port 0 stands for any port of the host.
+struct device_address
+{
+    // "255.255.255.255"
+    static constexpr std::size_t max_ip_chars = 15;
+
+    std::uint32_t ip{};
+    std::uint16_t port{};
+
+    constexpr device_address() = default;
+
+    constexpr device_address(std::uint32_t ip, std::uint16_t port = 0) noexcept
+        : ip{ ip }, port{ port } {
+    }
+
+    device_address(ns3::Ipv4Address ip, std::uint16_t port = 0) noexcept
+        : ip{ ip.Get() }, port{ port } {
+    }
+
+    // The zero address when `ip` is not a dotted quad or `port` is not a
+    // 16-bit number. An empty `port` is port 0.
+    static auto parse(std::string_view ip, std::string_view port = {}) noexcept -> device_address;
+
+    auto ipv4() const -> ns3::Ipv4Address {
+        return ns3::Ipv4Address(ip);
+    }
+
+    // Writes at most `max_ip_chars` characters and returns the end.
+    auto ip_to_chars(char* out) const noexcept -> char*;
+
+    auto ip_string() const -> std::string;
+
+    auto key() const noexcept -> std::uint64_t {
+        return static_cast<std::uint64_t>(ip) << 16 | port;
+    }
+
+    explicit operator bool() const noexcept {
+        return ip || port;
+    }
+
+    friend auto operator==(const device_address&, const device_address&) -> bool = default;
+    friend auto operator<=>(const device_address&, const device_address&) = default;
+};
+
+
+} // namespace okec
+
+
+template <>
+struct std::hash<okec::device_address> {
+    auto operator()(const okec::device_address& address) const noexcept -> std::size_t {
+        return std::hash<std::uint64_t>{}(address.key());
+    }
+};
+
+#endif // OKEC_DEVICE_ADDRESS_H_
@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_EXECUTION_MODEL_H_
+#define OKEC_EXECUTION_MODEL_H_
+
+#include <ns3/event-id.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace okec
+{
+
+// How a server shares its cpu among the tasks it holds.
+//
+// Every job carries `work` (its cpu demand) and is served at a rate assigned
+// by the concrete model, so a job's time reflects the contention it meets
+// for its whole life, not only at admission. A model keeps exactly one
+// pending simulator event, the earliest departure, and recomputes it
+// whenever a job arrives or leaves.
+class execution_model : public std::enable_shared_from_this<execution_model>
+{
+public:
+    // processing_time: from submission to completion, waiting included.
+    using completion_type = std::function<void(double processing_time)>;
+
+    // Called once, when the job first gets a share of the cpu.
+    using start_type      = std::function<void()>;
+
+    struct job
+    {
+        std::string id;
+        double work;
+        double remaining;
+        double rate;
+        double arrival_time;
+        int priority;
+        bool started;
+        start_type start;
+        completion_type done;
+    };
+
+public:
+    // capacity: cpu units per second, shared by `cores` identical cores.
+    execution_model(double capacity, std::size_t cores = 1);
+    virtual ~execution_model();
+
+    virtual auto name() const -> std::string_view = 0;
+
+    // Higher priority is served first by models that take it into account.
+    auto submit(std::string id, double work, completion_type done, int priority = 0) -> void;
+    auto submit(std::string id, double work, start_type start, completion_type done, int priority = 0) -> void;
+
+    auto capacity() const -> double;
+    auto cores() const -> std::size_t;
+
+    // Jobs currently held, running or waiting.
+    auto size() const -> std::size_t;
+
+    auto completed() const -> std::size_t;
+
+protected:
+    // Assigns `rate` to every job; jobs are kept in arrival order.
+    virtual auto allocate(std::vector<job>& jobs) -> void = 0;
+
+    auto core_speed() const -> double;
+
+private:
+    auto advance() -> void;
+    auto reschedule() -> void;
+    auto on_departure() -> void;
+
+private:
+    double capacity_;
+    std::size_t cores_;
+    std::vector<job> jobs_;
+    double last_update_{};
+    std::size_t completed_{};
+    ns3::EventId pending_;
+};
+
+
+// First come, first served on `cores` cores; later jobs wait for a free core.
+class fcfs_model : public execution_model
+{
+public:
+    using execution_model::execution_model;
+
+    auto name() const -> std::string_view override;
+
+protected:
+    auto allocate(std::vector<job>& jobs) -> void override;
+};
+
+
+// Egalitarian processor sharing; a job never runs faster than one core.
+class processor_sharing_model : public execution_model
+{
+public:
+    using execution_model::execution_model;
+
+    auto name() const -> std::string_view override;
+
+protected:
+    auto allocate(std::vector<job>& jobs) -> void override;
+};
+
+
+// Non-preemptive priority: a free core goes to the waiting job with the
+// highest priority, ties in arrival order.
+class priority_model : public execution_model
+{
+public:
+    using execution_model::execution_model;
+
+    auto name() const -> std::string_view override;
+
+protected:
+    auto allocate(std::vector<job>& jobs) -> void override;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_EXECUTION_MODEL_H_
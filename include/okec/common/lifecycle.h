@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_LIFECYCLE_H_
+#define OKEC_LIFECYCLE_H_
+
+#include <okec/common/task_id.h>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+namespace okec
+{
+
+// Hops of a task, in the order they happen.
+enum class stage : std::uint8_t {
+    client_send,
+    bs_receive,
+    decision,
+    es_receive,
+    start,
+    finish,
+    bs_forward,
+    client_receive,
+    count
+};
+
+// Intervals between consecutive stages.
+enum class segment : std::uint8_t {
+    uplink,       // client_send    -> bs_receive
+    queueing,     // bs_receive     -> decision
+    dispatch,     // decision       -> es_receive
+    server_wait,  // es_receive     -> start
+    compute,      // start          -> finish
+    return_path,  // finish         -> bs_forward
+    downlink,     // bs_forward     -> client_receive
+    total,        // client_send    -> client_receive
+    count
+};
+
+enum class label : std::uint8_t {
+    group,
+    engine,
+    device
+};
+
+// Simulated timestamps of every task at each hop, for attributing latency to
+// the network, queueing or compute. Disabled by default.
+class task_lifecycle
+{
+public:
+    static constexpr std::size_t stages = static_cast<std::size_t>(stage::count);
+    static constexpr std::size_t segments = static_cast<std::size_t>(segment::count);
+
+    struct record
+    {
+        std::array<double, stages> time;   // simulated seconds, NaN if not reached
+        std::array<std::uint32_t, 3> label; // interned group, engine, device
+    };
+
+public:
+    static auto instance() -> task_lifecycle&;
+
+    static auto enabled() -> bool {
+        return enabled_;
+    }
+
+    auto enable(bool on = true) -> void;
+
+    // Stamps the task with the current simulated time. The text overloads
+    // take the "task_id" header of a message.
+    auto mark(task_id id, stage s) -> void;
+    auto mark(std::string_view id, stage s) -> void;
+
+    auto set_label(task_id id, label key, std::string_view value) -> void;
+    auto set_label(std::string_view id, label key, std::string_view value) -> void;
+
+    auto size() const -> std::size_t;
+
+    // NaN if either end of the segment was not reached.
+    auto duration(const record& r, segment s) const -> double;
+
+    // Percentiles (0-100) of `s` grouped by `key`, over completed segments.
+    // [label value, one value per requested percentile]
+    auto percentiles(segment s, label key, const std::vector<double>& ps = { 50, 90, 99 }) const
+        -> std::map<std::string, std::vector<double>>;
+
+    // One row per task, one column per stage; empty cells for missing stages.
+    auto export_csv(const std::string& file) const -> bool;
+
+    auto print_summary(label key = label::engine) const -> void;
+
+    auto reset() -> void;
+
+    static auto segment_name(segment s) -> std::string_view;
+    static auto stage_name(stage s) -> std::string_view;
+
+private:
+    // `text` is kept for the export when the id is a hash of it.
+    auto find_or_create(task_id id, std::string_view text = {}) -> record&;
+    auto intern(std::string_view value) -> std::uint32_t;
+
+private:
+    static inline bool enabled_ = false;
+
+    std::vector<record> records_;
+    std::vector<task_id> ids_;
+    std::unordered_map<task_id, std::uint32_t> index_;
+    std::unordered_map<task_id, std::string> aliases_; // [hashed id, original text]
+    std::vector<std::string> labels_;
+    std::unordered_map<std::string, std::uint32_t> label_index_;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_LIFECYCLE_H_
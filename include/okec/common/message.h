@@ -14,13 +14,10 @@
 #include <okec/common/response.h>
 #include <okec/common/resource.h>
 #include <okec/common/task.h>
-#include <nlohmann/json.hpp>
+#include <okec/utils/json.h>
 #include <string_view>
 
 
-using json = nlohmann::json;
-
-
 namespace okec
 {
 
@@ -63,12 +60,12 @@ public:
         return result;
     }
 
-    operator json&() { return j_; }
+    operator arena_json&() { return j_; }
 
     auto valid() -> bool;
 
 private:
-    json j_;
+    arena_json j_;
 };
 
 
@@ -12,6 +12,7 @@
 #define OKEC_MESSAGE_HANDLER_H_
 
 #include <okec/utils/delegate.hpp>
+#include <okec/utils/profiler.h>
 #include <functional>
 #include <string>
 
@@ -33,6 +34,7 @@ public:
 		typename delegate_type::value_type::const_iterator iter;
 		bool ret = delegate_.find(msg_type, iter);
 		if (ret) {
+			profiler::scope s{ "message", msg_type };
 			iter->second(args...);
 		}
 
@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_PATH_TABLE_H_
+#define OKEC_PATH_TABLE_H_
+
+#include <ns3/vector.h>
+#include <vector>
+
+
+namespace okec
+{
+
+// Distances and estimated delays between a set of devices and an origin (the
+// decision device), and between the devices themselves. Distances to the
+// origin are kept up to date eagerly; the pairwise table is only allocated
+// when first asked for, filled in on use and dropped for a device when it moves.
+class path_table
+{
+public:
+    // Propagation speed in m/s. The default matches the cloud link estimate of
+    // the cloud-edge-end engine (3000km/s).
+    explicit path_table(double propagation_speed = 3000000.0);
+
+    auto resize(std::size_t n) -> void;
+    auto size() const -> std::size_t;
+
+    auto set_origin(const ns3::Vector& origin) -> void;
+    auto origin() const -> const ns3::Vector&;
+
+    auto set_position(std::size_t row, const ns3::Vector& position) -> void;
+    auto position(std::size_t row) const -> const ns3::Vector&;
+
+    auto set_propagation_speed(double speed) -> void;
+
+    // From the origin to `row`.
+    auto distance(std::size_t row) const -> double;
+    auto propagation_delay(std::size_t row) const -> double;
+
+    // Between two devices.
+    auto distance(std::size_t from, std::size_t to) const -> double;
+    auto propagation_delay(std::size_t from, std::size_t to) const -> double;
+
+    // Sending `size` Mb over `bandwidth` Mb/s to `row`, with the round trip propagation.
+    auto transmission_delay(std::size_t row, double size, double bandwidth) const -> double;
+
+    // Euclidean distance to the origin of an arbitrary position, e.g. a client.
+    auto distance_to_origin(const ns3::Vector& position) const -> double;
+
+private:
+    double speed_;
+    ns3::Vector origin_{};
+    std::vector<ns3::Vector> positions_;
+    std::vector<double> distances_; // to the origin
+    mutable std::vector<double> pairwise_; // row-major, NaN until computed
+};
+
+
+} // namespace okec
+
+#endif // OKEC_PATH_TABLE_H_
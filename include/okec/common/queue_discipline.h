@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_QUEUE_DISCIPLINE_H_
+#define OKEC_QUEUE_DISCIPLINE_H_
+
+#include <okec/common/task.h>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace okec
+{
+
+// Waiting time and utilization of the tasks dispatched from a base station queue.
+class queue_metrics
+{
+public:
+    auto on_dispatch(double wait_time, double cpu_demand) -> void;
+    auto on_release(double cpu_demand) -> void;
+
+    // Total cpu supply the dispatched demand is measured against.
+    auto set_capacity(double capacity) -> void;
+    auto capacity() const -> double;
+
+    auto dispatched() const -> std::size_t;
+    auto average_wait_time() const -> double;
+    auto max_wait_time() const -> double;
+
+    // Time-averaged in-flight demand over the capacity.
+    auto utilization() const -> double;
+
+private:
+    auto advance() -> void;
+
+private:
+    std::size_t dispatched_{};
+    double total_wait_{};
+    double max_wait_{};
+    double capacity_{};
+    double in_flight_{};
+    double busy_area_{};
+    double start_time_{ -1.0 };
+    double last_time_{};
+};
+
+
+class queue_discipline
+{
+public:
+    using sequence_type = std::vector<task_element>;
+    using iterator      = sequence_type::iterator;
+    using decision_type = json;
+    using decide_type   = std::function<decision_type(const task_element&)>;
+    using result_type   = std::pair<iterator, decision_type>;
+
+public:
+    virtual ~queue_discipline() = default;
+
+    virtual auto name() const -> std::string_view = 0;
+
+    // A discipline with the same settings, but without queue state or metrics.
+    virtual auto clone() const -> std::shared_ptr<queue_discipline> = 0;
+
+    // Picks the next pending task (status "0") and asks `decide` where it goes.
+    // The decision is null when the picked task has to wait, and the iterator
+    // is the end of the sequence when nothing is pending.
+    virtual auto select(sequence_type& sequence, const decide_type& decide) -> result_type = 0;
+
+    // `item` is about to leave the queue, answered or rejected. Drops what the
+    // discipline kept about it.
+    virtual auto on_remove(const task_element& item) -> void;
+
+    auto metrics() -> queue_metrics&;
+
+protected:
+    static auto is_pending(const task_element& item) -> bool;
+
+private:
+    queue_metrics metrics_;
+};
+
+
+// First come, first served. The head of the queue blocks until it fits.
+class fifo_discipline : public queue_discipline
+{
+public:
+    auto name() const -> std::string_view override;
+    auto clone() const -> std::shared_ptr<queue_discipline> override;
+    auto select(sequence_type& sequence, const decide_type& decide) -> result_type override;
+};
+
+
+// Earliest deadline first, the deadline being arrival_time + deadline.
+class edf_discipline : public queue_discipline
+{
+public:
+    auto name() const -> std::string_view override;
+    auto clone() const -> std::shared_ptr<queue_discipline> override;
+    auto select(sequence_type& sequence, const decide_type& decide) -> result_type override;
+};
+
+
+// Shortest cpu demand first.
+class sdf_discipline : public queue_discipline
+{
+public:
+    auto name() const -> std::string_view override;
+    auto clone() const -> std::shared_ptr<queue_discipline> override;
+    auto select(sequence_type& sequence, const decide_type& decide) -> result_type override;
+};
+
+
+// FIFO, but when the head does not fit a later task that does fit is
+// dispatched instead. The head can be overtaken at most `starvation_bound`
+// times, after which the queue blocks until it fits.
+class backfill_discipline : public queue_discipline
+{
+public:
+    explicit backfill_discipline(std::size_t starvation_bound = 16);
+
+    auto name() const -> std::string_view override;
+    auto clone() const -> std::shared_ptr<queue_discipline> override;
+    auto select(sequence_type& sequence, const decide_type& decide) -> result_type override;
+    auto on_remove(const task_element& item) -> void override;
+
+private:
+    std::size_t starvation_bound_;
+    std::unordered_map<task_id, std::size_t> bypassed_; // [task, times overtaken]
+};
+
+
+} // namespace okec
+
+#endif // OKEC_QUEUE_DISCIPLINE_H_
@@ -11,9 +11,14 @@
 #ifndef OKEC_RESOURCE_H_
 #define OKEC_RESOURCE_H_
 
+#include <okec/common/resource_tracer.h>
 #include <okec/utils/packet_helper.h>
 #include <ns3/core-module.h>
 #include <ns3/node-container.h>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
 
 
 
@@ -21,11 +26,27 @@ namespace okec
 {
 
 
+// Numeric resource attributes are kept as numbers and written back to the
+// json representation lazily, when it is read as a whole or as strings.
+// Attribute ids are global, so the same name has the same id on every device.
 class resource : public ns3::Object
 {
 public:
+    enum class attribute_type { real, integer };
+
+    using attribute_id = std::uint16_t;
+
+    struct change_event
+    {
+        std::uint32_t device;   // node id
+        attribute_id attribute;
+        double old_value;
+        double new_value;
+    };
+
     // [address, key, old_value, new_value]
     using monitor_type = std::function<void(std::string_view, std::string_view, std::string_view, std::string_view)>;
+    using change_monitor_type = std::function<void(const change_event&)>;
 
 public:
 
@@ -37,12 +58,40 @@ public:
     resource() = default;
     resource(json item) noexcept;
 
+    // String values that parse as numbers are stored as real numbers.
     auto attribute(std::string_view key, std::string_view value) -> void;
 
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    auto attribute(std::string_view key, T value, std::string_view unit = {}) -> void {
+        set_number(key, static_cast<double>(value), std::integral<T> ? attribute_type::integer : attribute_type::real, unit);
+    }
+
     auto reset_value(std::string_view key, std::string_view value) -> std::string;
 
+    // Numeric access. get returns 0 for a missing or non-numeric attribute.
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    auto get(std::string_view key) const -> T {
+        auto number = find_number(key);
+        return number ? static_cast<T>(number->value) : T{};
+    }
+
+    // Returns the old value.
+    auto set(std::string_view key, double value) -> double;
+
+    // Returns the new value.
+    auto add(std::string_view key, double delta) -> double;
+
+    auto unit(std::string_view key) const -> std::string_view;
+
     auto set_monitor(monitor_type monitor) -> void;
 
+    auto set_change_monitor(change_monitor_type monitor) -> void;
+
+    // Every reset_value is recorded as a delta, keyed by this resource's address.
+    auto set_tracer(std::shared_ptr<resource_tracer> tracer) -> void;
+
     auto get_value(std::string_view key) const -> std::string;
 
     auto get_address() -> ns3::Ipv4Address;
@@ -50,10 +99,12 @@ public:
     auto dump(const int indent = -1) -> std::string;
 
     auto begin() const {
+        sync();
         return this->empty() ? json::const_iterator() : j_["resource"].begin();
     }
 
     auto end() const {
+        sync();
         return this->empty() ? json::const_iterator() : j_["resource"].end();
     }
 
@@ -65,9 +116,33 @@ public:
 
     static auto from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> resource;
 
+    static auto id_of(std::string_view key) -> attribute_id;
+    static auto name_of(attribute_id id) -> const std::string&;
+
 private:
-    json j_;
+    struct number
+    {
+        attribute_id id;
+        attribute_type type;
+        double value;
+        std::string unit;
+        bool dirty;
+    };
+
+    auto find_number(std::string_view key) const -> const number*;
+    auto find_number(std::string_view key) -> number*;
+    auto set_number(std::string_view key, double value, attribute_type type, std::string_view unit) -> void;
+    auto changed(const number& n, double old_value) -> void;
+    auto load_numbers() -> void;
+    auto sync() const -> void;
+
+private:
+    mutable json j_;
+    mutable std::vector<number> numbers_;
+    mutable bool dirty_{};
     monitor_type monitor_;
+    change_monitor_type change_monitor_;
+    std::shared_ptr<resource_tracer> tracer_;
     ns3::Ptr<ns3::Node> node_;
 };
 
@@ -108,15 +183,24 @@ public:
 
     auto print(std::string title = "Resource Info" ) -> void;
 
+    // Deprecated: enables tracing on the first call and converts the trace to
+    // data/resource_tracer.csv when it is closed. Later calls are no-ops since
+    // every change is already captured.
     auto trace_resource() -> void;
 
+    // Records the current values, then every change, to a binary trace.
+    auto enable_tracing(std::string file = "data/resource_tracer.bin", bool background = false) -> std::shared_ptr<resource_tracer>;
+
     auto save_to_file(const std::string& file) -> void;
     auto load_from_file(const std::string& file) -> bool;
 
     auto set_monitor(resource::monitor_type monitor) -> void;
 
+    auto set_change_monitor(resource::change_monitor_type monitor) -> void;
+
 private:
     std::vector<ns3::Ptr<resource>> m_resources;
+    std::shared_ptr<resource_tracer> m_tracer;
 };
 
 } // namespace okec
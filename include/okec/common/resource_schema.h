@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_RESOURCE_SCHEMA_H_
+#define OKEC_RESOURCE_SCHEMA_H_
+
+#include <okec/common/task.h>
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace okec
+{
+
+// The numeric resource dimensions of a scenario, e.g. cpu, memory, storage,
+// bandwidth. Supplies are read from the resource attributes of the same name
+// and demands from the task headers of the same name. Defaults to { "cpu" }.
+class resource_schema
+{
+public:
+    static constexpr std::size_t max_dimensions = 8;
+
+    using vector_type = std::array<double, max_dimensions>;
+
+public:
+    static auto instance() -> resource_schema&;
+
+    // Registers the dimensions once per scenario, before the decision engine runs.
+    auto define(std::vector<std::string> dimensions) -> void;
+
+    auto dimensions() const -> std::size_t;
+    auto name(std::size_t index) const -> const std::string&;
+    auto index_of(std::string_view name) const -> std::optional<std::size_t>;
+
+    // Bumped by define(), so cached vectors know when to rebuild.
+    auto generation() const -> std::size_t;
+
+    // Missing or non-numeric values count as 0.
+    auto demand(const task_element& item) const -> vector_type;
+    auto supply(const arena_json& item) const -> vector_type;
+
+private:
+    resource_schema();
+
+private:
+    std::vector<std::string> names_;
+    std::size_t generation_{};
+};
+
+
+enum class placement_policy {
+    worst_fit, // most normalized capacity left over
+    best_fit,  // least normalized capacity left over
+    dominant   // largest smallest normalized leftover, i.e. the most balanced server
+};
+
+
+// Server supplies stored column-wise, one contiguous column per dimension, so
+// the feasibility and scoring passes are plain loops over servers that the
+// compiler vectorizes.
+class resource_matrix
+{
+public:
+    using vector_type = resource_schema::vector_type;
+
+public:
+    auto resize(std::size_t rows, std::size_t dimensions) -> void;
+
+    auto rows() const -> std::size_t;
+    auto dimensions() const -> std::size_t;
+
+    auto set_row(std::size_t row, const vector_type& supply) -> void;
+    auto set(std::size_t row, std::size_t dimension, double value) -> void;
+    auto get(std::size_t row, std::size_t dimension) const -> double;
+
+    // Disabled rows are never picked.
+    auto set_enabled(std::size_t row, bool enabled) -> void;
+
+    // The best row able to hold `demand` on every dimension. Leftovers are
+    // normalized by the largest supply of their dimension before scoring.
+    auto place(const vector_type& demand, placement_policy policy) const -> std::optional<std::size_t>;
+
+private:
+    std::size_t rows_{};
+    std::size_t dimensions_{};
+    std::array<std::vector<double>, resource_schema::max_dimensions> columns_;
+    std::vector<double> enabled_; // 1.0 or 0.0
+
+    // scratch buffers, kept to avoid allocating per decision
+    mutable std::vector<double> score_;
+    mutable std::vector<double> feasible_;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_RESOURCE_SCHEMA_H_
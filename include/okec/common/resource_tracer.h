@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_RESOURCE_TRACER_H_
+#define OKEC_RESOURCE_TRACER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+namespace okec
+{
+
+// Append-only binary trace of resource changes. Only the changed attribute is
+// recorded, as a fixed-size record, into an in-memory block that is written
+// out when full (on a background thread if requested) and when the tracer is
+// closed. Node and attribute names are interned and written once.
+//
+// File layout: the magic "OKRT" and a version byte, then tagged records:
+//   'N' u32 id, u16 length, bytes   node name
+//   'A' u16 id, u16 length, bytes   attribute name
+//   'D' f64 time, u32 node, u16 attribute, f64 value
+//   'M' f64 time, u16 length, bytes marker (e.g. an episode boundary)
+// All numbers are little-endian as in memory.
+class resource_tracer
+{
+public:
+    enum class layout {
+        wide, // one row per instant, one column per node/attribute (forward filled)
+        tall  // time,node,attribute,value
+    };
+
+public:
+    explicit resource_tracer(std::string file, std::size_t block_size = 1 << 20, bool background = false);
+    ~resource_tracer();
+
+    resource_tracer(const resource_tracer&) = delete;
+    resource_tracer& operator=(const resource_tracer&) = delete;
+
+    // Records `attribute` of `node` becoming `value` at the current simulated time.
+    auto record(std::string_view node, std::string_view attribute, double value) -> void;
+    auto record(std::string_view node, std::string_view attribute, std::string_view value) -> void;
+
+    auto mark(std::string_view text) -> void;
+
+    // Writes the current block out.
+    auto flush() -> void;
+
+    // Flushes, stops the writer thread and closes the file. Also done on destruction.
+    auto close() -> void;
+
+    // Converts the file when it is closed.
+    auto convert_on_close(std::string csv_file, layout l = layout::wide) -> void;
+
+    auto file() const -> const std::string&;
+    auto records() const -> std::size_t;
+
+    // Converters of a closed trace file.
+    static auto to_csv(const std::string& trace_file, const std::string& csv_file, layout l = layout::wide) -> bool;
+
+    // One raw little-endian array per column (time.f64, node.u32, attribute.u16,
+    // value.f64) plus names.csv mapping ids to names, in `directory`.
+    static auto to_columns(const std::string& trace_file, const std::string& directory) -> bool;
+
+private:
+    auto node_id(std::string_view node) -> std::uint32_t;
+    auto attribute_id(std::string_view attribute) -> std::uint16_t;
+
+    template <typename T>
+    auto put(const T& value) -> void;
+    auto put_bytes(std::string_view bytes) -> void;
+
+    auto submit_block() -> void;
+    auto writer_loop() -> void;
+
+private:
+    std::string file_;
+    std::ofstream out_;
+    std::size_t block_size_;
+    std::vector<char> block_;
+    std::size_t records_{};
+    bool closed_{};
+
+    struct string_hash
+    {
+        using is_transparent = void;
+
+        auto operator()(std::string_view text) const noexcept -> std::size_t {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+
+    // looked up by string_view, so recording a known name does not allocate
+    std::unordered_map<std::string, std::uint32_t, string_hash, std::equal_to<>> nodes_;
+    std::unordered_map<std::string, std::uint16_t, string_hash, std::equal_to<>> attributes_;
+
+    std::string convert_file_;
+    layout convert_layout_{ layout::wide };
+
+    // background writer
+    bool background_;
+    std::thread writer_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::vector<char>> pending_;
+    bool stopping_{};
+};
+
+
+} // namespace okec
+
+#endif // OKEC_RESOURCE_TRACER_H_
@@ -23,8 +23,8 @@ class response {
 public:
     using attribute_type         = std::pair<std::string_view, std::string_view>;
     using attributes_type        = std::initializer_list<attribute_type>;
-    using value_type             = json;
-    using iterator               = json::iterator;
+    using value_type             = arena_json;
+    using iterator               = arena_json::iterator;
     using unary_predicate_type   = std::function<bool(const value_type&)>;
     using binary_predicate_type  = std::function<bool(const value_type&, const value_type&)>;
 
@@ -60,10 +60,10 @@ public:
     auto dump_with(attribute_type value) -> response;
 
 private:
-    auto emplace_back(json item) -> void;
+    auto emplace_back(arena_json item) -> void;
 
 private:
-    json j_;
+    arena_json j_;
 };
 
 
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_SCENARIO_H_
+#define OKEC_SCENARIO_H_
+
+#include <okec/devices/base_station.h>
+#include <okec/devices/client_device.h>
+#include <okec/devices/cloud_server.h>
+#include <okec/devices/edge_device.h>
+#include <okec/network/network_model.hpp>
+#include <okec/utils/json.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace okec
+{
+
+class simulator;
+
+// Devices, links, resources and workload of a simulation, built from a
+// description such as:
+//
+// {
+//     "network": {
+//         "model": "cloud_edge_end",
+//         "links": { "edge": { "data_rate": "5Mbps", "delay": "2ms" } },
+//         "wifi": { "ssid": "ns-3-ssid", "bounds": 50 }
+//     },
+//     "base_stations": [
+//         { "count": 2, "edge_servers": 5, "clients": 10, "resources": { "cpu": [2.1, 2.2] } }
+//     ],
+//     "cloud": { "resources": { "cpu": 50 } },
+//     "workload": { "tasks_per_client": 10, "attributes": { "cpu": [0.2, 1.2], "size": 1 } },
+//     "stop_time": 300
+// }
+//
+// A value is either fixed (a number or a numeric string) or drawn uniformly
+// from [low, high] once per device or task.
+class scenario
+{
+public:
+    // Throws std::invalid_argument listing every problem of the description.
+    // Nothing is created unless the whole description is valid.
+    scenario(simulator& sim, const json& description);
+
+    scenario(const scenario&) = delete;
+    scenario& operator=(const scenario&) = delete;
+
+    static auto load(simulator& sim, const std::string& file) -> std::unique_ptr<scenario>;
+
+    auto base_stations() -> base_station_container&;
+
+    // One container per base station.
+    auto edge_servers() -> std::vector<edge_device_container>&;
+    auto clients() -> std::vector<client_device_container>&;
+
+    // Null when the scenario has no cloud tier.
+    auto cloud() -> cloud_server*;
+
+    // Sends the workload from every client. Call it once the decision engine
+    // is initialized.
+    auto launch() -> void;
+
+private:
+    struct value_range {
+        double low;
+        double high;
+    };
+
+    using attributes = std::vector<std::pair<std::string, value_range>>;
+
+    struct cell {
+        std::size_t edge_servers;
+        std::size_t clients;
+        attributes resources;
+    };
+
+    struct plan {
+        std::string model;
+        link_settings links;
+        std::vector<cell> cells;
+        bool has_cloud{};
+        attributes cloud_resources;
+        std::size_t tasks_per_client{};
+        attributes task_attributes;
+        double stop_time{};
+    };
+
+    scenario(simulator& sim, plan&& p);
+
+    static auto parse(const json& description) -> plan;
+    static auto draw(const value_range& range) -> std::string;
+
+    auto build_network() -> void;
+    auto install_resources() -> void;
+
+private:
+    plan plan_;
+    base_station_container base_stations_;
+    std::vector<edge_device_container> edge_servers_;
+    std::vector<client_device_container> clients_;
+    std::unique_ptr<cloud_server> cloud_;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_SCENARIO_H_
@@ -2,11 +2,16 @@
 #define OKEC_SIMULATOR_H_
 
 #include <okec/common/awaitable.h>
+#include <okec/common/device_address.h>
+#include <okec/utils/profiler.h>
 #include <functional>
+#include <memory>
 #include <ns3/core-module.h>
 
 namespace okec {
 
+class link_model;
+class memory_arena;
 class response;
 
 class simulator {
@@ -16,65 +21,99 @@ public:
 
     auto run() -> void;
 
+    // In okec time, which runs ahead of ns-3 time after a checkpoint is
+    // restored; see now::offset().
     auto stop_time(ns3::Time time) -> void;
     auto stop_time() const -> ns3::Time;
 
     auto enable_visualizer() -> void;
 
+    // Delivers messages after the latency of `model` (a bandwidth_link_model
+    // by default) instead of sending them through the ns-3 packet stack. The
+    // network model is still needed to assign the addresses.
+    auto enable_fast_network(std::shared_ptr<link_model> model = nullptr) -> void;
+    auto disable_fast_network() -> void;
+
+    // Profiles message handlers and events scheduled through okec::schedule().
+    // The table is printed and the flame graph written when run() returns.
+    auto enable_profiler(std::string folded_file = "okec_profile.folded") -> void;
+
+    // The arena the JSON trees of this simulation are allocated from.
+    auto memory() const -> const memory_arena&;
+
+    // Completions are keyed by the client's address; the text overloads take
+    // its dotted-quad IP.
+    auto submit(device_address client, std::function<void(response&&)> fn) -> void;
     auto submit(const std::string& ip, std::function<void(response&&)> fn) -> void;
 
+    auto complete(device_address client, response&& r) -> void;
     auto complete(const std::string& ip, response&& r) -> void;
 
-    auto is_valid(const std::string& ip) -> bool;
+    auto is_valid(device_address client) const -> bool;
+    auto is_valid(const std::string& ip) const -> bool;
 
     auto hold_coro(awaitable a) -> void;
 
 private:
+    memory_arena* arena_;
     ns3::Time stop_time_;
+    std::string profile_file_;
     std::vector<awaitable> coros_;
-    std::unordered_map<std::string, std::function<void(response&&)>> completion_;
+    std::unordered_map<device_address, std::function<void(response&&)>> completion_;
 };
 
 namespace now {
 
+    // Simulated time the run resumed from, set when a checkpoint is restored.
+    // ns-3 always starts at zero; okec time is ns-3 time plus this offset.
+    inline auto offset() -> ns3::Time& {
+        static ns3::Time value{};
+        return value;
+    }
+
+    inline auto time() -> ns3::Time {
+        const auto& shift = offset();
+        return shift.IsZero() ? ns3::Simulator::Now() : ns3::Simulator::Now() + shift;
+    }
+
     inline auto years() -> double {
-        return ns3::Simulator::Now().GetYears();
+        return time().GetYears();
     }
 
     inline auto days() -> double {
-        return ns3::Simulator::Now().GetDays();
+        return time().GetDays();
     }
 
     inline auto hours() -> double {
-        return ns3::Simulator::Now().GetHours();
+        return time().GetHours();
     }
 
     inline auto minutes() -> double {
-        return ns3::Simulator::Now().GetMinutes();
+        return time().GetMinutes();
     }
 
     inline auto seconds() -> double {
-        return ns3::Simulator::Now().GetSeconds();
+        return time().GetSeconds();
     }
 
     inline auto milli_seconds() -> double {
-        return ns3::Simulator::Now().GetMilliSeconds();
+        return time().GetMilliSeconds();
     }
 
     inline auto micro_seconds() -> double {
-        return ns3::Simulator::Now().GetMicroSeconds();
+        return time().GetMicroSeconds();
     }
 
     inline auto nano_seconds() -> double {
-        return ns3::Simulator::Now().GetNanoSeconds();
+        return time().GetNanoSeconds();
     }
 
     inline auto pico_seconds() -> double {
-        return ns3::Simulator::Now().GetPicoSeconds();
+        return time().GetPicoSeconds();
     }
 
     inline auto femto_seconds() -> double {
-        return ns3::Simulator::Now().GetFemtoSeconds();
+        return time().GetFemtoSeconds();
     }
 
 } // namespace now
@@ -11,23 +11,33 @@
 #ifndef OKEC_TASK_H_
 #define OKEC_TASK_H_
 
+#include <okec/common/task_id.h>
 #include <okec/utils/packet_helper.h>
+#include <memory>
 #include <string>
 
 
 namespace okec
 {
 
+// A handle to one task item. Either a view that reads and writes the item in
+// place inside its task, or a payload shared between copies: copying is a
+// reference count increment and the first write to a shared payload clones it.
+// Copying a view takes a snapshot, so the copy never refers to the task.
 class task_element
 {
+    friend class task;
+    friend class message;
+
 public:
-    task_element(json* item) noexcept;
+    task_element(arena_json* item) noexcept;
     task_element(json item) noexcept;
+    task_element(arena_json item) noexcept;
     task_element(const task_element& other) noexcept;
     task_element& operator=(const task_element& other) noexcept;
     task_element(task_element&& other) noexcept;
     task_element& operator=(task_element&& other) noexcept;
-    ~task_element();
+    ~task_element() = default;
 
     auto get_header(const std::string& key) const -> std::string;
     auto set_header(std::string_view key, std::string_view value) -> bool;
@@ -37,19 +47,39 @@ public:
 
     auto j_data() const -> json;
 
+    // The "task_id" header, parsed once when the handle is created and again
+    // when set_header() changes it; zero when missing.
+    auto id() const -> task_id;
+
     auto empty() const -> bool;
 
+    // Whether the payload is held by other copies as well.
+    auto shared() const -> bool;
+
     static auto from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> task_element;
 
     auto dump(int indent = -1) const -> std::string;
 
 private:
-    json* elem_;
-    bool is_dynamically_allocated;
+    // A read-only view into a const task, cloned on the first write.
+    task_element(const arena_json* item, bool read_only) noexcept;
+
+    // The item to write to, cloned first unless this handle owns it alone.
+    auto mutable_data() -> arena_json*;
+
+    auto assign(const task_element& other) -> void;
+
+private:
+    arena_json* elem_{};
+    std::shared_ptr<arena_json> payload_; // null for views
+    bool read_only_{};
+    task_id id_{};
 };
 
 class task : public ns3::SimpleRefCount<task>
 {
+    friend class message;
+
     using attribute_t      = std::pair<std::string, std::string>;
     using attributes_t     = std::initializer_list<attribute_t>;
 
@@ -60,6 +90,7 @@ public:
 public:
     task() = default;
     task(json other);
+    task(arena_json other);
 
     // construct task from packet
     static auto from_packet(ns3::Ptr<ns3::Packet> packet) -> task;
@@ -70,9 +101,17 @@ public:
     
     auto dump(int indent = -1) const -> std::string;
 
-    auto elements_view() -> std::vector<task_element>;
+    // Standalone copies of the items, valid after the task is gone.
     auto elements() const -> std::vector<task_element>;
 
+    // Both return views, which must not outlive the task. Writes through
+    // elements_view() change the task; element_views() clones an item on write.
+    auto elements_view() -> std::vector<task_element>;
+    auto element_views() const -> std::vector<task_element>;
+
+    // Moves the items out into standalone elements and leaves the task null.
+    auto release_elements() -> std::vector<task_element>;
+
     auto at(std::size_t index) noexcept -> task_element;
     auto at(std::size_t index) const noexcept -> task_element;
     
@@ -97,6 +136,7 @@ public:
     static auto get_header(const json& element, const std::string& key) -> std::string;
     static auto get_body(const json& element, const std::string& key) -> std::string;
 
+    // The hex form of task_id::next().
     static auto unique_id() -> std::string;
 
     auto save_to_file(const std::string& file_name) -> void;
@@ -106,10 +146,10 @@ public:
     auto operator[](std::size_t index) const noexcept -> task_element;
 
 private:
-    auto push_back(const json& sub) -> void;
+    auto push_back(const arena_json& sub) -> void;
 
 private:
-    json m_task;
+    arena_json m_task;
 };
 
 
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_TASK_ID_H_
+#define OKEC_TASK_ID_H_
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+
+namespace okec
+{
+
+// 128-bit task identifier: a random run id drawn once per process and a
+// sequence number counting the ids handed out. Ids are compared and hashed as
+// integers; the 32-digit hex form only exists in packets and output.
+struct task_id
+{
+    static constexpr std::size_t digits = 32;
+
+    std::uint64_t run{};
+    std::uint64_t sequence{};
+
+    // A fresh id, unique within the process.
+    static auto next() noexcept -> task_id;
+
+    // The id next() returned last, and making next() continue after it, so a
+    // restored checkpoint hands out the ids the original run would have.
+    static auto last() noexcept -> task_id;
+    static auto resume_after(task_id last) noexcept -> void;
+
+    // The value of exactly 32 uppercase hex digits, as to_chars() writes
+    // them. Any other text, e.g. a hand-written id, is mapped to a hash of it
+    // with every bit of `run` set.
+    static auto parse(std::string_view text) noexcept -> task_id;
+
+    // Writes exactly `digits` uppercase hex digits and returns the end.
+    auto to_chars(char* out) const noexcept -> char*;
+
+    auto to_string() const -> std::string;
+
+    // Whether the id was parsed from text that is not hex.
+    auto hashed() const noexcept -> bool {
+        return run == ~std::uint64_t{};
+    }
+
+    explicit operator bool() const noexcept {
+        return run || sequence;
+    }
+
+    friend auto operator==(const task_id&, const task_id&) -> bool = default;
+    friend auto operator<=>(const task_id&, const task_id&) = default;
+};
+
+
+} // namespace okec
+
+
+template <>
+struct std::hash<okec::task_id> {
+    auto operator()(const okec::task_id& id) const noexcept -> std::size_t {
+        // Sequence numbers of one run differ in the low bits; mix the run in.
+        return static_cast<std::size_t>(id.sequence ^ (id.run * 0x9E3779B97F4A7C15ull));
+    }
+};
+
+#endif // OKEC_TASK_ID_H_
@@ -12,7 +12,9 @@
 #define OKEC_BASE_STATION_H_
 
 #include <okec/algorithms/decision_engine.h>
+#include <okec/common/admission_controller.h>
 #include <okec/common/message.h>
+#include <okec/common/queue_discipline.h>
 #include <okec/devices/cloud_server.h>
 #include <okec/devices/edge_device.h>
 #include <okec/utils/log.h>
@@ -76,6 +78,17 @@ public:
 
     auto handle_next() -> void;
 
+    // 任务队列的调度策略，默认为 FIFO
+    auto set_queue_discipline(std::shared_ptr<queue_discipline> discipline) -> void;
+    auto get_queue_discipline() const -> std::shared_ptr<queue_discipline>;
+
+    // 任务准入控制，未设置时接收全部任务
+    auto set_admission_controller(std::shared_ptr<admission_controller> controller) -> void;
+    auto get_admission_controller() const -> std::shared_ptr<admission_controller>;
+
+    // delay 秒后再次调用 handle_next，已有更早的重试时忽略
+    auto schedule_retry(double delay) -> void;
+
 public:
     simulator& sim_;
     edge_device_container* m_edge_devices;
@@ -84,6 +97,9 @@ public:
     std::vector<task_element> m_task_sequence;
     std::vector<char> m_task_sequence_status; // 0: 未分发；1：已分发
     std::shared_ptr<decision_engine> m_decision_engine;
+    std::shared_ptr<queue_discipline> m_queue_discipline;
+    std::shared_ptr<admission_controller> m_admission_controller;
+    ns3::EventId m_retry_event;
 };
 
 
@@ -138,6 +154,11 @@ public:
 
     auto set_decision_engine(std::shared_ptr<decision_engine> engine) -> void;
 
+    // 每个基站得到 discipline 的一份 clone()，统计需通过各基站的 get_queue_discipline() 读取
+    auto set_queue_discipline(std::shared_ptr<queue_discipline> discipline) -> void;
+
+    auto set_admission_controller(std::shared_ptr<admission_controller> controller) -> void;
+
 private:
     std::vector<pointer_t> m_base_stations;
 };
@@ -74,6 +74,9 @@ public:
 
     auto set_request_handler(std::string_view msg_type, callback_type callback) -> void;
 
+    // Called with every response after the decision engine has handled it.
+    auto set_response_observer(std::function<void(message&)> observer) -> void;
+
     auto dispatch(std::string_view msg_type, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) -> void;
 
     auto response_cache() -> response_type&;
@@ -91,6 +94,7 @@ private:
     response_type m_response;
     done_callback_t m_done_fn;
     std::shared_ptr<decision_engine> m_decision_engine;
+    std::function<void(message&)> m_response_observer;
 };
 
 
@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_CLIENT_POPULATION_H_
+#define OKEC_CLIENT_POPULATION_H_
+
+#include <okec/devices/client_device.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+namespace okec
+{
+
+// Logical users multiplexed onto a few client devices (the carriers). User u
+// sends through carrier u % carriers; its tasks carry a "user_id" header that
+// the decision engines copy into the responses, where it is demultiplexed.
+// A user costs a few counters instead of a node, a socket and a Wi-Fi device.
+class client_population
+{
+public:
+    using user_id = std::uint32_t;
+    using response_callback = std::function<void(user_id, message&)>;
+
+public:
+    client_population(client_device_container& carriers, std::size_t users);
+    client_population(std::vector<client_device_container>& carriers, std::size_t users);
+
+    auto size() const -> std::size_t;
+    auto carrier_of(user_id user) const -> std::shared_ptr<client_device>;
+
+    // Sends `t` on behalf of `user`.
+    auto send(user_id user, task t) -> void;
+
+    // Called with every response after the per-user counters are updated.
+    auto on_response(response_callback callback) -> void;
+
+    auto sent(user_id user) const -> std::uint32_t;
+    auto finished(user_id user) const -> std::uint32_t;
+    auto failed(user_id user) const -> std::uint32_t;
+
+    // Mean processing time of the finished tasks of `user`.
+    auto average_time(user_id user) const -> double;
+
+private:
+    auto attach() -> void;
+    auto receive(message& msg) -> void;
+
+private:
+    std::vector<std::shared_ptr<client_device>> carriers_;
+    response_callback callback_;
+
+    // Per-user state, one column per counter.
+    std::vector<std::uint32_t> sent_;
+    std::vector<std::uint32_t> finished_;
+    std::vector<std::uint32_t> failed_;
+    std::vector<double> time_;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_CLIENT_POPULATION_H_
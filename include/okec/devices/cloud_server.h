@@ -11,6 +11,7 @@
 #ifndef OKEC_CLOUD_DEVICE_H
 #define OKEC_CLOUD_DEVICE_H
 
+#include <okec/common/execution_model.h>
 #include <okec/common/task.h>
 #include <okec/common/resource.h>
 #include <okec/network/udp_application.h>
@@ -45,6 +46,10 @@ public:
     // 为当前设备安装资源
     auto install_resource(ns3::Ptr<resource> res) -> void;
 
+    // 为当前设备安装执行模型
+    auto set_execution_model(std::shared_ptr<execution_model> model) -> void;
+    auto get_execution_model() const -> std::shared_ptr<execution_model>;
+
     auto set_position(double x, double y, double z) -> void;
     auto get_position() -> ns3::Vector;
 
@@ -60,6 +65,7 @@ private:
     simulator& sim_;
     ns3::Ptr<ns3::Node> m_node;
     ns3::Ptr<udp_application> m_udp_application;
+    std::shared_ptr<execution_model> m_execution_model;
 };
 
 
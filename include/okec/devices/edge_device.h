@@ -11,6 +11,7 @@
 #ifndef OKEC_EDGE_DEVICE_H_
 #define OKEC_EDGE_DEVICE_H_
 
+#include <okec/common/execution_model.h>
 #include <okec/common/resource.h>
 #include <okec/network/udp_application.h>
 
@@ -43,6 +44,10 @@ public:
     // 为当前设备安装资源
     auto install_resource(ns3::Ptr<resource> res) -> void;
 
+    // 为当前设备安装执行模型，未安装时任务按到达时的空闲资源独立计时
+    auto set_execution_model(std::shared_ptr<execution_model> model) -> void;
+    auto get_execution_model() const -> std::shared_ptr<execution_model>;
+
     auto set_position(double x, double y, double z) -> void;
     auto get_position() -> ns3::Vector;
 
@@ -57,6 +62,7 @@ public:
     simulator& sim_;
     ns3::Ptr<ns3::Node> m_node;
     ns3::Ptr<okec::udp_application> m_udp_application;
+    std::shared_ptr<execution_model> m_execution_model;
 };
 
 
@@ -0,0 +1,356 @@
+#ifndef OKEC_BINARY_TRACE_HPP_
+#define OKEC_BINARY_TRACE_HPP_
+
+#include <okec/common/simulator.h>
+#include <okec/devices/client_device.h>
+#include <okec/utils/log.h>
+#include <okec/utils/profiler.h>
+#include "ns3/constant-velocity-mobility-model.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace okec
+{
+
+// Binary, time-sorted form of an ns-2 mobility trace:
+//
+//   header    "OKMT", u32 version, u32 nodes, u32 reserved (zero), u64 waypoints
+//   initial   nodes x { f64 x, f64 y, f64 z }
+//   index     nodes x { u64 first waypoint, u64 count }
+//   waypoints { f64 time, f64 x, f64 y, f64 speed }, grouped by node and
+//             sorted by time within a node
+//
+// A setdest starts moving towards (x, y) at `speed`; a non-positive speed
+// places the node at (x, y) at once.
+class binary_trace_mobility : public std::enable_shared_from_this<binary_trace_mobility> {
+public:
+    static constexpr char magic[4] = { 'O', 'K', 'M', 'T' };
+    static constexpr std::uint32_t version = 1;
+
+    struct header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t nodes;
+        std::uint32_t reserved;
+        std::uint64_t waypoints;
+    };
+
+    struct position {
+        double x, y, z;
+    };
+
+    struct span {
+        std::uint64_t first;
+        std::uint64_t count;
+    };
+
+    struct waypoint {
+        double time;
+        double x, y;
+        double speed;
+    };
+
+public:
+    // Maps `file` read-only; nothing is parsed up front.
+    explicit binary_trace_mobility(const std::string& file) {
+        fd_ = ::open(file.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            log::error("Failed to open mobility trace {}", file);
+            return;
+        }
+
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(header)) {
+            log::error("{} is not a binary mobility trace", file);
+            return;
+        }
+
+        size_ = static_cast<std::size_t>(st.st_size);
+        auto data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (data == MAP_FAILED) {
+            log::error("Failed to map mobility trace {}", file);
+            size_ = 0;
+            return;
+        }
+        data_ = static_cast<const char*>(data);
+
+        const auto& head = *reinterpret_cast<const header*>(data_);
+        bool sized = head.waypoints <= size_ / sizeof(waypoint);
+        auto expected = sizeof(header) + std::size_t{ head.nodes } * (sizeof(position) + sizeof(span)) + head.waypoints * sizeof(waypoint);
+        if (std::memcmp(head.magic, magic, sizeof(magic)) != 0 || head.version != version || !sized || size_ < expected || !spans_fit()) {
+            log::error("{} is not a valid binary mobility trace", file);
+            ::munmap(const_cast<char*>(data_), size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    ~binary_trace_mobility() {
+        if (data_)
+            ::munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    binary_trace_mobility(const binary_trace_mobility&) = delete;
+    binary_trace_mobility& operator=(const binary_trace_mobility&) = delete;
+
+    auto valid() const -> bool {
+        return data_ != nullptr;
+    }
+
+    auto nodes() const -> std::size_t {
+        return valid() ? head().nodes : 0;
+    }
+
+    auto waypoints() const -> std::size_t {
+        return valid() ? head().waypoints : 0;
+    }
+
+    // Trace node i drives the i-th client, as with ns3::Ns2MobilityHelper. Only
+    // the next event of each node is scheduled; waypoints are read from the
+    // mapping as they come due. The object keeps itself alive while events remain.
+    auto install(client_device_container& clients) -> void {
+        if (!valid())
+            return;
+
+        auto count = std::min<std::size_t>(nodes(), clients.size());
+        if (count < nodes())
+            log::warning("The mobility trace has {} nodes but only {} clients.", nodes(), clients.size());
+
+        states_.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto node = clients.get_device(i)->get_node();
+            auto model = node->GetObject<ns3::ConstantVelocityMobilityModel>();
+            if (!model) {
+                model = ns3::CreateObject<ns3::ConstantVelocityMobilityModel>();
+                node->AggregateObject(model);
+            }
+
+            const auto& start = initial()[i];
+            model->SetPosition(ns3::Vector(start.x, start.y, start.z));
+
+            auto& state = states_[i];
+            state.model = model;
+            state.next = first_waypoint() + index()[i].first;
+            state.end = state.next + index()[i].count;
+            schedule_next(i);
+        }
+    }
+
+    static auto is_binary_trace(const std::string& file) -> bool {
+        char head[sizeof(magic)]{};
+        std::ifstream in{ file, std::ios::binary };
+        return in.read(head, sizeof(head)) && std::memcmp(head, magic, sizeof(magic)) == 0;
+    }
+
+    // Converts an ns-2 trace of "$node_(i) set X_|Y_|Z_ v" and
+    // "$ns_ at t "$node_(i) setdest x y speed"" lines.
+    static auto convert(const std::string& ns2_file, const std::string& binary_file) -> bool {
+        std::ifstream in{ ns2_file };
+        if (!in) {
+            log::error("{} does not exist!", ns2_file);
+            return false;
+        }
+
+        std::map<std::uint32_t, position> initial;
+        std::map<std::uint32_t, std::vector<waypoint>> paths;
+        std::size_t skipped{};
+
+        std::string line;
+        while (std::getline(in, line)) {
+            std::string_view text{ line };
+            double time = -1.0;
+            if (consume(text, "$ns_ at ") && (!number(text, time) || !consume(text, "\""))) {
+                ++skipped;
+                continue;
+            }
+
+            std::uint32_t node{};
+            if (!consume(text, "$node_(") || !number(text, node) || !consume(text, ")")) {
+                if (!text.empty() && text.front() != '#')
+                    ++skipped;
+                continue;
+            }
+
+            if (consume(text, "setdest ")) {
+                waypoint w{ time, 0.0, 0.0, 0.0 };
+                if (time < 0 || !number(text, w.x) || !number(text, w.y) || !number(text, w.speed)) {
+                    ++skipped;
+                    continue;
+                }
+                paths[node].push_back(w);
+                initial.try_emplace(node);
+            } else if (consume(text, "set ") && time < 0) {
+                auto& p = initial[node];
+                double value{};
+                if (consume(text, "X_") && number(text, value)) p.x = value;
+                else if (consume(text, "Y_") && number(text, value)) p.y = value;
+                else if (consume(text, "Z_") && number(text, value)) p.z = value;
+                else ++skipped;
+            } else {
+                ++skipped;
+            }
+        }
+
+        if (skipped)
+            log::warning("{} unsupported lines in {} were skipped.", skipped, ns2_file);
+
+        std::uint32_t nodes = initial.empty() ? 0 : initial.rbegin()->first + 1;
+        std::vector<position> positions(nodes, position{});
+        std::vector<span> spans(nodes, span{});
+        std::vector<waypoint> all;
+        for (auto& [node, p] : initial)
+            positions[node] = p;
+        for (auto& [node, path] : paths) {
+            std::ranges::stable_sort(path, {}, &waypoint::time);
+            spans[node] = { all.size(), path.size() };
+            all.insert(all.end(), path.begin(), path.end());
+        }
+
+        header head{};
+        std::memcpy(head.magic, magic, sizeof(magic));
+        head.version = version;
+        head.nodes = nodes;
+        head.waypoints = all.size();
+
+        std::ofstream out{ binary_file, std::ios::binary | std::ios::trunc };
+        out.write(reinterpret_cast<const char*>(&head), sizeof(head));
+        out.write(reinterpret_cast<const char*>(positions.data()), positions.size() * sizeof(position));
+        out.write(reinterpret_cast<const char*>(spans.data()), spans.size() * sizeof(span));
+        out.write(reinterpret_cast<const char*>(all.data()), all.size() * sizeof(waypoint));
+        return static_cast<bool>(out);
+    }
+
+private:
+    struct node_state {
+        ns3::Ptr<ns3::ConstantVelocityMobilityModel> model;
+        const waypoint* next{};
+        const waypoint* end{};
+        bool moving{};
+        double arrival{};
+        ns3::Vector destination{};
+    };
+
+    auto head() const -> const header& {
+        return *reinterpret_cast<const header*>(data_);
+    }
+
+    auto initial() const -> const position* {
+        return reinterpret_cast<const position*>(data_ + sizeof(header));
+    }
+
+    auto index() const -> const span* {
+        return reinterpret_cast<const span*>(initial() + head().nodes);
+    }
+
+    auto first_waypoint() const -> const waypoint* {
+        return reinterpret_cast<const waypoint*>(index() + head().nodes);
+    }
+
+    // Every node's waypoints lie within the waypoint section.
+    auto spans_fit() const -> bool {
+        auto total = head().waypoints;
+        return std::all_of(index(), index() + head().nodes, [total](const span& s) {
+            return s.first <= total && s.count <= total - s.first;
+        });
+    }
+
+    auto schedule_next(std::size_t i) -> void {
+        auto& state = states_[i];
+        double due = std::numeric_limits<double>::infinity();
+        if (state.next != state.end)
+            due = state.next->time;
+        if (state.moving)
+            due = std::min(due, state.arrival);
+        if (std::isinf(due))
+            return;
+
+        auto delay = std::max(due - now::seconds(), 0.0);
+        okec::schedule(ns3::Seconds(delay), [self = shared_from_this(), i]() {
+            self->advance(i);
+        });
+    }
+
+    auto advance(std::size_t i) -> void {
+        constexpr double epsilon = 1e-9;
+        auto& state = states_[i];
+        double current = now::seconds();
+
+        if (state.moving && current + epsilon >= state.arrival) {
+            state.model->SetVelocity(ns3::Vector(0.0, 0.0, 0.0));
+            state.model->SetPosition(state.destination);
+            state.moving = false;
+        }
+
+        for (; state.next != state.end && state.next->time <= current + epsilon; ++state.next)
+            apply(state, *state.next, current);
+
+        schedule_next(i);
+    }
+
+    static auto apply(node_state& state, const waypoint& w, double current) -> void {
+        auto from = state.model->GetPosition();
+        ns3::Vector to(w.x, w.y, from.z);
+        double distance = ns3::CalculateDistance(from, to);
+
+        if (w.speed <= 0.0 || distance == 0.0) {
+            state.model->SetVelocity(ns3::Vector(0.0, 0.0, 0.0));
+            state.model->SetPosition(to);
+            state.moving = false;
+            return;
+        }
+
+        state.model->SetVelocity(ns3::Vector((to.x - from.x) / distance * w.speed, (to.y - from.y) / distance * w.speed, 0.0));
+        state.destination = to;
+        state.arrival = current + distance / w.speed;
+        state.moving = true;
+    }
+
+    static auto consume(std::string_view& text, std::string_view prefix) -> bool {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+            text.remove_prefix(1);
+        if (!text.starts_with(prefix))
+            return false;
+        text.remove_prefix(prefix.size());
+        return true;
+    }
+
+    template <typename T>
+    static auto number(std::string_view& text, T& value) -> bool {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+            text.remove_prefix(1);
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc{})
+            return false;
+        text.remove_prefix(static_cast<std::size_t>(ptr - text.data()));
+        return true;
+    }
+
+private:
+    int fd_{ -1 };
+    const char* data_{};
+    std::size_t size_{};
+    std::vector<node_state> states_;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_BINARY_TRACE_HPP_
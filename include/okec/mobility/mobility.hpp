@@ -5,6 +5,7 @@
 #include <okec/devices/client_device.h>
 #include <okec/devices/cloud_server.h>
 #include <okec/devices/edge_device.h>
+#include <okec/mobility/binary_trace.hpp>
 #include <okec/utils/log.h>
 #include "ns3/ns2-mobility-helper.h"
 #include "ns3/mobility-helper.h"
@@ -35,8 +36,14 @@ struct mobility {
         auto start = std::chrono::high_resolution_clock::now();
         okec::println("Loading mobility model from {}...", filename);
 
-        ns3::Ns2MobilityHelper trace(std::move(filename));
-        trace.Install(wifiStaNodes.Begin(), wifiStaNodes.End());
+        // Binary traces (see binary_trace_mobility::convert) are streamed from
+        // a memory mapping instead of being parsed up front.
+        if (binary_trace_mobility::is_binary_trace(filename)) {
+            std::make_shared<binary_trace_mobility>(filename)->install(clients);
+        } else {
+            ns3::Ns2MobilityHelper trace(std::move(filename));
+            trace.Install(wifiStaNodes.Begin(), wifiStaNodes.End());
+        }
 
         auto end = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double> duration = end - start;
@@ -0,0 +1,242 @@
+#ifndef OKEC_SPATIAL_INDEX_HPP_
+#define OKEC_SPATIAL_INDEX_HPP_
+
+#include <okec/devices/base_station.h>
+#include <okec/devices/client_device.h>
+#include <okec/utils/log.h>
+#include "ns3/mobility-model.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace okec
+{
+
+// k-d tree over a fixed set of points, cycling through x, y and z.
+class kd_tree {
+public:
+    kd_tree() = default;
+
+    explicit kd_tree(std::vector<ns3::Vector> points) {
+        build(std::move(points));
+    }
+
+    auto build(std::vector<ns3::Vector> points) -> void {
+        points_ = std::move(points);
+        order_.resize(points_.size());
+        std::iota(order_.begin(), order_.end(), 0uz);
+        build(0, order_.size(), 0);
+    }
+
+    auto size() const -> std::size_t {
+        return points_.size();
+    }
+
+    // Index of the closest point (the lowest one on ties), or size() when empty.
+    auto nearest(const ns3::Vector& position) const -> std::size_t {
+        std::size_t best = points_.size();
+        double best_distance = std::numeric_limits<double>::infinity();
+        nearest(0, order_.size(), 0, position, best, best_distance);
+        return best;
+    }
+
+private:
+    static auto coordinate(const ns3::Vector& v, int axis) -> double {
+        return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+    }
+
+    static auto squared_distance(const ns3::Vector& a, const ns3::Vector& b) -> double {
+        double dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    auto build(std::size_t first, std::size_t last, int axis) -> void {
+        if (last - first < 2)
+            return;
+
+        auto middle = first + (last - first) / 2;
+        std::nth_element(order_.begin() + first, order_.begin() + middle, order_.begin() + last,
+            [this, axis](std::size_t lhs, std::size_t rhs) {
+                return coordinate(points_[lhs], axis) < coordinate(points_[rhs], axis);
+            });
+
+        build(first, middle, (axis + 1) % 3);
+        build(middle + 1, last, (axis + 1) % 3);
+    }
+
+    auto nearest(std::size_t first, std::size_t last, int axis, const ns3::Vector& position,
+        std::size_t& best, double& best_distance) const -> void {
+        if (first >= last)
+            return;
+
+        auto middle = first + (last - first) / 2;
+        auto index = order_[middle];
+        auto distance = squared_distance(points_[index], position);
+        if (distance < best_distance || (distance == best_distance && index < best)) {
+            best_distance = distance;
+            best = index;
+        }
+
+        // The far side can only hold a closer point if the splitting plane is closer.
+        double delta = coordinate(position, axis) - coordinate(points_[index], axis);
+        auto next = (axis + 1) % 3;
+        if (delta < 0) {
+            nearest(first, middle, next, position, best, best_distance);
+            if (delta * delta <= best_distance)
+                nearest(middle + 1, last, next, position, best, best_distance);
+        } else {
+            nearest(middle + 1, last, next, position, best, best_distance);
+            if (delta * delta <= best_distance)
+                nearest(first, middle, next, position, best, best_distance);
+        }
+    }
+
+private:
+    std::vector<ns3::Vector> points_;
+    std::vector<std::size_t> order_;
+};
+
+
+// Which base station serves each client. Clients are followed through the
+// CourseChange trace of their mobility model and handed over to the nearest
+// base station when they move. The index has to outlive the simulation run.
+class spatial_index {
+public:
+    using pointer_t = std::shared_ptr<base_station>;
+
+    // [client, previous cell (null when first attached), new cell]
+    using handover_callback = std::function<void(client_device*, pointer_t, pointer_t)>;
+
+public:
+    explicit spatial_index(base_station_container& base_stations) {
+        rebuild(base_stations);
+    }
+
+    // Takes the current base station positions, e.g. after moving one, and
+    // re-attaches the tracked clients.
+    auto rebuild(base_station_container& base_stations) -> void {
+        cells_.assign(base_stations.begin(), base_stations.end());
+
+        std::vector<ns3::Vector> positions;
+        positions.reserve(cells_.size());
+        for (const auto& bs : cells_)
+            positions.push_back(bs->get_position());
+        tree_.build(std::move(positions));
+
+        members_.assign(cells_.size(), {});
+        auto serving = std::exchange(serving_, {});
+        for (auto [client, cell] : serving)
+            update(client, client->get_position());
+    }
+
+    auto nearest(const ns3::Vector& position) const -> pointer_t {
+        auto cell = tree_.nearest(position);
+        return cell < cells_.size() ? cells_[cell] : nullptr;
+    }
+
+    auto track(client_device_container& clients) -> void {
+        for (const auto& client : clients)
+            track(client);
+    }
+
+    auto track(std::shared_ptr<client_device> client) -> void {
+        auto mobility = client->get_node()->GetObject<ns3::MobilityModel>();
+        if (!mobility) {
+            log::warning("client({:ip}) has no mobility model and is not tracked.", client->get_address());
+            return;
+        }
+
+        if (!serving_.contains(client.get())) {
+            mobility->TraceConnectWithoutContext("CourseChange",
+                ns3::MakeBoundCallback(&spatial_index::course_changed, this, client.get()));
+        }
+        update(client.get(), mobility->GetPosition());
+    }
+
+    // The cell serving `client`, or null when it is not tracked.
+    auto serving(const client_device* client) const -> pointer_t {
+        auto it = serving_.find(const_cast<client_device*>(client));
+        return it != serving_.end() ? cells_[it->second] : nullptr;
+    }
+
+    auto clients_of(const base_station* bs) const -> std::vector<client_device*> {
+        for (std::size_t cell = 0; cell < cells_.size(); ++cell) {
+            if (cells_[cell].get() == bs)
+                return { members_[cell].begin(), members_[cell].end() };
+        }
+        return {};
+    }
+
+    auto on_handover(handover_callback callback) -> void {
+        handover_ = std::move(callback);
+    }
+
+    // A client only leaves its cell when the new one is closer by more than
+    // `meters`, so clients on a border do not bounce between cells.
+    auto set_hysteresis(double meters) -> void {
+        hysteresis_ = meters;
+    }
+
+    auto handovers() const -> std::size_t {
+        return handovers_;
+    }
+
+private:
+    static auto course_changed(spatial_index* self, client_device* client, ns3::Ptr<const ns3::MobilityModel> mobility) -> void {
+        self->update(client, mobility->GetPosition());
+    }
+
+    auto update(client_device* client, const ns3::Vector& position) -> void {
+        auto cell = tree_.nearest(position);
+        if (cell >= cells_.size())
+            return;
+
+        auto it = serving_.find(client);
+        if (it == serving_.end()) {
+            serving_.emplace(client, cell);
+            members_[cell].insert(client);
+            if (handover_)
+                handover_(client, nullptr, cells_[cell]);
+            return;
+        }
+
+        auto current = it->second;
+        if (current == cell)
+            return;
+
+        if (hysteresis_ > 0.0) {
+            auto to_current = ns3::CalculateDistance(position, cells_[current]->get_position());
+            auto to_nearest = ns3::CalculateDistance(position, cells_[cell]->get_position());
+            if (to_current - to_nearest <= hysteresis_)
+                return;
+        }
+
+        members_[current].erase(client);
+        members_[cell].insert(client);
+        it->second = cell;
+        ++handovers_;
+        if (handover_)
+            handover_(client, cells_[current], cells_[cell]);
+    }
+
+private:
+    std::vector<pointer_t> cells_;
+    kd_tree tree_;
+    std::unordered_map<client_device*, std::size_t> serving_; // [client, cell]
+    std::vector<std::unordered_set<client_device*>> members_;
+    handover_callback handover_;
+    double hysteresis_{};
+    std::size_t handovers_{};
+};
+
+
+} // namespace okec
+
+#endif // OKEC_SPATIAL_INDEX_HPP_
@@ -21,6 +21,8 @@ namespace okec
 // okec::cloud_edge_end_model model;
 // okec::network_initializer(model, user_devices, base_stations, cloud_server);
 struct cloud_edge_end_model {
+    link_settings links;
+
     auto network_initializer(
         client_device_container& clients,
         base_station_container::pointer_t base_station,
@@ -35,8 +37,7 @@ struct cloud_edge_end_model {
         p2pNodes.Add(edgeNodes.Get(0));
 
         ns3::PointToPointHelper pointToPoint;
-        pointToPoint.SetDeviceAttribute("DataRate", ns3::StringValue("5Mbps"));
-        pointToPoint.SetChannelAttribute("Delay", ns3::StringValue("2ms"));
+        apply_link(pointToPoint, links.edge);
 
         ns3::NetDeviceContainer p2pDevices;
         p2pDevices = pointToPoint.Install(p2pNodes);
@@ -48,8 +49,7 @@ struct cloud_edge_end_model {
         p2pCloudNodes.Add(base_station->get_node());
 
         ns3::PointToPointHelper p2pCloudHelper;
-        p2pCloudHelper.SetDeviceAttribute("DataRate", ns3::StringValue("50Mbps"));
-        p2pCloudHelper.SetChannelAttribute("Delay", ns3::StringValue("5ms"));
+        apply_link(p2pCloudHelper, links.cloud);
 
         ns3::NetDeviceContainer p2pCloudDevice;
         p2pCloudDevice = p2pCloudHelper.Install(p2pCloudNodes);
@@ -58,8 +58,7 @@ struct cloud_edge_end_model {
 
         
         ns3::CsmaHelper csma;
-        csma.SetChannelAttribute("DataRate", ns3::StringValue("100Mbps"));
-        csma.SetChannelAttribute("Delay", ns3::TimeValue(ns3::NanoSeconds(6560)));
+        apply_link(csma, links.lan);
 
         ns3::NetDeviceContainer csmaDevices;
         csmaDevices = csma.Install(edgeNodes);
@@ -73,7 +72,7 @@ struct cloud_edge_end_model {
         phy.SetChannel(channel.Create());
 
         ns3::WifiMacHelper mac;
-        ns3::Ssid ssid = ns3::Ssid("ns-3-ssid");
+        ns3::Ssid ssid = ns3::Ssid(links.wifi.ssid);
 
         ns3::WifiHelper wifi;
 
@@ -183,7 +182,7 @@ struct cloud_edge_end_model {
         }
 
         // Connect all base stations
-        ns3::NodeContainer p2pAPNodes[APs-1];
+        std::vector<ns3::NodeContainer> p2pAPNodes(std::max(APs - 1, 0));
         for (auto const& indices : std::views::iota(0, APs) | std::views::slide(2)) {
             auto it = std::begin(indices);
             p2pAPNodes[*it].Add(base_stations[*it]->get_node());
@@ -192,10 +191,9 @@ struct cloud_edge_end_model {
 
 
         ns3::PointToPointHelper p2pAPHelper;
-        p2pAPHelper.SetDeviceAttribute("DataRate", ns3::StringValue("50Mbps"));
-        p2pAPHelper.SetChannelAttribute("Delay", ns3::StringValue("5ms"));
+        apply_link(p2pAPHelper, links.backbone);
 
-        ns3::NetDeviceContainer p2pAPDevices[APs-1];
+        std::vector<ns3::NetDeviceContainer> p2pAPDevices(std::max(APs - 1, 0));
         for (auto i : std::views::iota(0, APs-1)) {
             p2pAPDevices[i] = p2pAPHelper.Install(p2pAPNodes[i]);
         }
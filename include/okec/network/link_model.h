@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_LINK_MODEL_H_
+#define OKEC_LINK_MODEL_H_
+
+#include <ns3/node.h>
+#include <ns3/nstime.h>
+#include <ns3/random-variable-stream.h>
+#include <cstdint>
+
+
+namespace okec
+{
+
+// How long a message takes between two nodes when the fast network mode
+// delivers it directly instead of through the ns-3 packet stack.
+class link_model
+{
+public:
+    virtual ~link_model() = default;
+
+    virtual auto latency(ns3::Ptr<ns3::Node> from, ns3::Ptr<ns3::Node> to, std::uint32_t bytes) -> ns3::Time = 0;
+};
+
+
+// delay + bytes / bandwidth + distance / propagation speed + U(0, jitter).
+// The distance is taken from the mobility models, and is 0 when a node has none.
+class bandwidth_link_model : public link_model
+{
+public:
+    // `bandwidth` in Mbps, `propagation_speed` in m/s.
+    explicit bandwidth_link_model(double bandwidth = 100.0,
+        ns3::Time delay = ns3::MilliSeconds(2),
+        ns3::Time jitter = ns3::Time{},
+        double propagation_speed = 200000000.0);
+
+    auto latency(ns3::Ptr<ns3::Node> from, ns3::Ptr<ns3::Node> to, std::uint32_t bytes) -> ns3::Time override;
+
+private:
+    double bandwidth_;
+    ns3::Time delay_;
+    ns3::Time jitter_;
+    double speed_;
+    ns3::Ptr<ns3::UniformRandomVariable> random_;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_LINK_MODEL_H_
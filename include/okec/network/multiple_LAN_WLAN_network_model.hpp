@@ -22,6 +22,7 @@ namespace okec
  * 
 */
 struct multiple_LAN_WLAN_network_model {
+    link_settings links{ .wifi = { .ssid = "scene2-network-" } };
 
     /**
      * @brief A custom function to initialize a scenario with multiple LANs and multiple WLANs.
@@ -41,8 +42,8 @@ struct multiple_LAN_WLAN_network_model {
         }
 
         // Create the P2P connection between AP and LAN
-        ns3::NodeContainer p2pNodes[APs];
-        ns3::NodeContainer edgeNodes[APs];
+        std::vector<ns3::NodeContainer> p2pNodes(APs);
+        std::vector<ns3::NodeContainer> edgeNodes(APs);
         for (auto i : std::views::iota(0, APs)) {
             base_stations[i]->get_edge_nodes(edgeNodes[i]);
             p2pNodes[i].Add(base_stations[i]->get_node());
@@ -50,15 +51,13 @@ struct multiple_LAN_WLAN_network_model {
         }
 
         ns3::PointToPointHelper p2pHelper;
-        p2pHelper.SetDeviceAttribute("DataRate", ns3::StringValue("5Mbps"));
-        p2pHelper.SetChannelAttribute("Delay", ns3::StringValue("2ms"));
+        apply_link(p2pHelper, links.edge);
         ns3::CsmaHelper csmaHelper;
-        csmaHelper.SetChannelAttribute("DataRate", ns3::StringValue("100Mbps"));
-        csmaHelper.SetChannelAttribute("Delay", ns3::TimeValue(ns3::NanoSeconds(6560)));
+        apply_link(csmaHelper, links.lan);
         
         // Create multiple LAN
         ns3::NetDeviceContainer p2pDevices;
-        ns3::NetDeviceContainer csmaDevices[APs]; // Each CSMA LAN must have a unique net device.
+        std::vector<ns3::NetDeviceContainer> csmaDevices(APs); // Each CSMA LAN must have a unique net device.
         for (auto i : std::views::iota(0, APs)) {
             p2pDevices.Add(p2pHelper.Install(p2pNodes[i]));
             csmaDevices[i] = csmaHelper.Install(edgeNodes[i]);
@@ -67,7 +66,7 @@ struct multiple_LAN_WLAN_network_model {
 
         // Create multiple AP and STA
         ns3::NodeContainer wifiApNodes;
-        ns3::NodeContainer wifiStaNodes[APs];
+        std::vector<ns3::NodeContainer> wifiStaNodes(APs);
         for (auto i : std::views::iota(0, APs)) {
             wifiApNodes.Add(base_stations[i]->get_node());
             clients[i].get_nodes(wifiStaNodes[i]);
@@ -80,9 +79,9 @@ struct multiple_LAN_WLAN_network_model {
         ns3::Ssid ssid;
 
         ns3::NetDeviceContainer apDevices;
-        ns3::NetDeviceContainer staDevices[APs];
+        std::vector<ns3::NetDeviceContainer> staDevices(APs);
         for (auto i : std::views::iota(0, APs)) {
-            ssid = ns3::Ssid("scene2-network-" + std::to_string(i));
+            ssid = ns3::Ssid(links.wifi.ssid + std::to_string(i));
             wifiPhy.SetChannel(wifiChannel.Create());
             
             // Assign SSID for each AP
@@ -113,7 +112,7 @@ struct multiple_LAN_WLAN_network_model {
 
         mobility.SetMobilityModel("ns3::RandomWalk2dMobilityModel",
                                 "Bounds",
-                                ns3::RectangleValue(ns3::Rectangle(-50, 50, -50, 50)));
+                                ns3::RectangleValue(ns3::Rectangle(-links.wifi.bounds, links.wifi.bounds, -links.wifi.bounds, links.wifi.bounds)));
         for (auto i : std::views::iota(0, APs)) {
             mobility.Install(wifiStaNodes[i]);
         }
@@ -148,7 +147,7 @@ struct multiple_LAN_WLAN_network_model {
         }
 
         // Connect base stations
-        ns3::NodeContainer p2pAPNodes[APs-1];
+        std::vector<ns3::NodeContainer> p2pAPNodes(std::max(APs - 1, 0));
         for (auto const& indices : std::views::iota(0, APs) | std::views::slide(2)) {
             auto it = std::begin(indices);
             p2pAPNodes[*it].Add(base_stations[*it]->get_node());
@@ -156,10 +155,9 @@ struct multiple_LAN_WLAN_network_model {
         }
 
         ns3::PointToPointHelper p2pAPHelper;
-        p2pAPHelper.SetDeviceAttribute("DataRate", ns3::StringValue("50Mbps"));
-        p2pAPHelper.SetChannelAttribute("Delay", ns3::StringValue("5ms"));
+        apply_link(p2pAPHelper, links.backbone);
 
-        ns3::NetDeviceContainer p2pAPDevices[APs-1];
+        std::vector<ns3::NetDeviceContainer> p2pAPDevices(std::max(APs - 1, 0));
         for (auto i : std::views::iota(0, APs-1)) {
             p2pAPDevices[i] = p2pAPHelper.Install(p2pAPNodes[i]);
         }
@@ -18,6 +18,7 @@ namespace okec
 {
 
 struct multiple_and_single_LAN_WLAN_network_model {
+    link_settings links;
 
     auto network_initializer(
         client_device_container& clients,
@@ -32,16 +33,14 @@ struct multiple_and_single_LAN_WLAN_network_model {
         p2pNodes.Add(edgeNodes.Get(0));
 
         ns3::PointToPointHelper pointToPoint;
-        pointToPoint.SetDeviceAttribute("DataRate", ns3::StringValue("5Mbps"));
-        pointToPoint.SetChannelAttribute("Delay", ns3::StringValue("2ms"));
+        apply_link(pointToPoint, links.edge);
 
         ns3::NetDeviceContainer p2pDevices;
         p2pDevices = pointToPoint.Install(p2pNodes);
 
         
         ns3::CsmaHelper csma;
-        csma.SetChannelAttribute("DataRate", ns3::StringValue("100Mbps"));
-        csma.SetChannelAttribute("Delay", ns3::TimeValue(ns3::NanoSeconds(6560)));
+        apply_link(csma, links.lan);
 
         ns3::NetDeviceContainer csmaDevices;
         csmaDevices = csma.Install(edgeNodes);
@@ -55,7 +54,7 @@ struct multiple_and_single_LAN_WLAN_network_model {
         phy.SetChannel(channel.Create());
 
         ns3::WifiMacHelper mac;
-        ns3::Ssid ssid = ns3::Ssid("ns-3-ssid");
+        ns3::Ssid ssid = ns3::Ssid(links.wifi.ssid);
 
         ns3::WifiHelper wifi;
 
@@ -91,7 +90,7 @@ struct multiple_and_single_LAN_WLAN_network_model {
 
         mobility.SetMobilityModel("ns3::RandomWalk2dMobilityModel",
                                 "Bounds",
-                                ns3::RectangleValue(ns3::Rectangle(-50, 50, -50, 50)));
+                                ns3::RectangleValue(ns3::Rectangle(-links.wifi.bounds, links.wifi.bounds, -links.wifi.bounds, links.wifi.bounds)));
         mobility.Install(wifiStaNodes);
 
         mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
@@ -147,7 +146,7 @@ struct multiple_and_single_LAN_WLAN_network_model {
         }
 
         // Connect all base stations
-        ns3::NodeContainer p2pAPNodes[APs-1];
+        std::vector<ns3::NodeContainer> p2pAPNodes(std::max(APs - 1, 0));
         for (auto const& indices : std::views::iota(0, APs) | std::views::slide(2)) {
             auto it = std::begin(indices);
             p2pAPNodes[*it].Add(base_stations[*it]->get_node());
@@ -156,10 +155,9 @@ struct multiple_and_single_LAN_WLAN_network_model {
 
 
         ns3::PointToPointHelper p2pAPHelper;
-        p2pAPHelper.SetDeviceAttribute("DataRate", ns3::StringValue("50Mbps"));
-        p2pAPHelper.SetChannelAttribute("Delay", ns3::StringValue("5ms"));
+        apply_link(p2pAPHelper, links.backbone);
 
-        ns3::NetDeviceContainer p2pAPDevices[APs-1];
+        std::vector<ns3::NetDeviceContainer> p2pAPDevices(std::max(APs - 1, 0));
         for (auto i : std::views::iota(0, APs-1)) {
             p2pAPDevices[i] = p2pAPHelper.Install(p2pAPNodes[i]);
         }
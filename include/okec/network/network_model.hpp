@@ -14,6 +14,7 @@
 #include <okec/devices/base_station.h>
 #include <okec/devices/client_device.h>
 #include <okec/common/resource.h>
+#include <okec/network/topology_builder.hpp>
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
 #include "ns3/applications-module.h"
@@ -24,10 +25,44 @@
 #include "ns3/mobility-helper.h"
 #include "ns3/rectangle.h"
 
+#include <string>
+
 
 namespace okec
 {
 
+// A link is described the way ns-3 attributes are written, e.g. "5Mbps" and "2ms".
+struct link_config {
+    std::string data_rate;
+    std::string delay;
+};
+
+struct wifi_config {
+    std::string ssid = "ns-3-ssid";  // 多基站时作为前缀，后接基站序号
+    double bounds = 50.0;            // 用户随机游走的范围 [-bounds, bounds]
+};
+
+// The links of the built-in network models. The defaults are the values the
+// models were written with.
+struct link_settings {
+    link_config edge{ "5Mbps", "2ms" };        // base station <--> edge LAN
+    link_config lan{ "100Mbps", "6560ns" };    // edge server LAN
+    link_config cloud{ "50Mbps", "5ms" };      // base station <--> cloud
+    link_config backbone{ "50Mbps", "5ms" };   // base station <--> base station
+    wifi_config wifi;
+};
+
+inline auto apply_link(ns3::PointToPointHelper& helper, const link_config& link) -> void {
+    helper.SetDeviceAttribute("DataRate", ns3::StringValue(link.data_rate));
+    helper.SetChannelAttribute("Delay", ns3::StringValue(link.delay));
+}
+
+inline auto apply_link(ns3::CsmaHelper& helper, const link_config& link) -> void {
+    helper.SetChannelAttribute("DataRate", ns3::StringValue(link.data_rate));
+    helper.SetChannelAttribute("Delay", ns3::StringValue(link.delay));
+}
+
+
 template <class T>
 inline constexpr bool enable_network_model = false;
 
@@ -42,7 +77,7 @@ auto network_initializer(Model& model, Args&&... args) {
 }
 
 
-void initialize_communication(client_device_container& client, 
+inline void initialize_communication(client_device_container& client, 
     base_station& bs, cloud_server& cs)
 {
     ns3::NodeContainer lan1_nodes, lan2_nodes, lan3_nodes;
@@ -132,7 +167,11 @@ void initialize_communication(client_device_container& client,
     ns3::Ipv4GlobalRoutingHelper::PopulateRoutingTables();
 }
 
-void initialize_communication(client_device_container& client, 
+// 每个基站以自身为网关、经独立的点对点链路接入核心路由器，用户设备与云服务器所在的局域网
+// 直接连接核心路由器。与原先每个基站两组路由器一样，用户设备到各基站、各基站到云服务器都只
+// 经过一跳点对点链路，且各基站独享其链路带宽。
+// 路由在建网时静态下发，基站数量增加到数千时仍能快速完成建网。
+inline void initialize_communication(client_device_container& client, 
     base_station_container& base_stations, cloud_server& cloud)
 {
     // 读取用户端、基站、云服务器三层的设备
@@ -140,128 +179,18 @@ void initialize_communication(client_device_container& client,
     client.get_nodes(lan_client);
     cloud.get_nodes(lan_cloud);
 
-    auto bs_size = base_stations.size();
-    ns3::NodeContainer lan_bs[bs_size];
-    std::size_t i;
-    for (i = 0; i < bs_size; ++i) {
-        base_stations[i]->get_nodes(lan_bs[i]);
-    }
-
-    // 准备路由器
-    // 为每个基站都配置左右两个路由器
-    ns3::NodeContainer router_level_one[bs_size], router_level_two[bs_size];
-    for (i = 0; i < bs_size; ++i) {
-        router_level_one[i].Create(2);
-        router_level_two[i].Create(2);
-    }
-
-    // 连接用户设备和基站间的路由器
-    ns3::CsmaHelper csma1;
-    csma1.SetChannelAttribute("DataRate", ns3::StringValue("50Mbps"));
-    csma1.SetChannelAttribute("Delay", ns3::TimeValue(ns3::NanoSeconds(6560)));
-    for (i = 0; i < bs_size; ++i) {
-        lan_client.Add(router_level_one[i].Get(0));
-    }
-    ns3::NetDeviceContainer lan_client_devices;
-    lan_client_devices = csma1.Install(lan_client);
-
-    // 基站配置路由器
-    ns3::CsmaHelper csma2;
-    csma2.SetChannelAttribute("DataRate", ns3::StringValue("100Mbps"));
-    csma2.SetChannelAttribute("Delay", ns3::TimeValue(ns3::NanoSeconds(6560)));
-    ns3::NetDeviceContainer lan_bs_devices[bs_size];
-    for (i = 0; i < bs_size; ++i) {
-        lan_bs[i].Add(router_level_one[i].Get(1)); // 连接基站与用户设备间的路由器
-        lan_bs[i].Add(router_level_two[i].Get(0)); // 连接基站与云服务器间的路由器
-
-        lan_bs_devices[i] = csma2.Install(lan_bs[i]);
-    }
-
-    // 配置一层路由器
-    ns3::PointToPointHelper p2p_one;
-    p2p_one.SetDeviceAttribute("DataRate", ns3::StringValue("10Mbps"));
-    p2p_one.SetChannelAttribute("Delay", ns3::StringValue("2ms"));
-    ns3::NetDeviceContainer router_level_one_devices[bs_size];
-    for (i = 0; i < bs_size; ++i) {
-        router_level_one_devices[i] = p2p_one.Install(router_level_one[i]);
-    }
-
-    // 配置云服务器路由
-    ns3::CsmaHelper csma3;
-    csma3.SetChannelAttribute("DataRate", ns3::StringValue("100Mbps"));
-    csma3.SetChannelAttribute("Delay", ns3::TimeValue(ns3::NanoSeconds(6560)));
-    ns3::NetDeviceContainer lan_cloud_devices;
-    for (i = 0; i < bs_size; ++i) {
-        lan_cloud.Add(router_level_two[i].Get(1));
-
-        lan_cloud_devices = csma3.Install(lan_cloud);
-    }
-
-    // 配置二层路由器
-    ns3::PointToPointHelper p2p_two;
-    p2p_two.SetDeviceAttribute("DataRate", ns3::StringValue("10Mbps"));
-    p2p_two.SetChannelAttribute("Delay", ns3::StringValue("2ms"));
-    ns3::NetDeviceContainer router_level_two_devices[bs_size];
-    for (i = 0; i < bs_size; ++i) {
-        router_level_two_devices[i] = p2p_two.Install(router_level_two[i]);
-    }
-
-    // 安装协议栈
-    ns3::InternetStackHelper stack;
-    stack.Install(lan_client);
-    stack.Install(lan_cloud);
-    for (i = 0; i < bs_size; ++i) {
-        stack.Install(lan_bs[i]);
-    }
-
-    // 设置 IP 地址
-    ns3::Ipv4AddressHelper address;
-
-    // 为用户设备设置 IP 地址
-    address.SetBase("10.1.1.0", "255.255.255.0");
-    ns3::Ipv4InterfaceContainer lan_client_interfaces;
-    lan_client_interfaces = address.Assign(lan_client_devices);
-
-    // 为基站设置 IP 地址
-    int base = 2;
-    ns3::Ipv4InterfaceContainer lan_bs_interfaces[bs_size];
-    for (i = 0; i < bs_size; ++i) {
-        std::string ip{ "10.1." };
-        ip.append(std::to_string(base++));
-        ip.append(".0");
-        address.SetBase(ip.c_str(), "255.255.255.0");
-        lan_bs_interfaces[i] = address.Assign(lan_bs_devices[i]);
-    }
-    
-    // 为云服务器设置 IP 地址
-    address.SetBase("10.1.50.0", "255.255.255.0");
-    ns3::Ipv4InterfaceContainer lan_cloud_interfaces;
-    lan_cloud_interfaces = address.Assign(lan_cloud_devices);
-
-    // 为一层路由设置 IP 地址
-    base = 100;
-    ns3::Ipv4InterfaceContainer router_level_one_interface[bs_size];
-    for (i = 0; i < bs_size; ++i) {
-        std::string ip{ "10.1." };
-        ip.append(std::to_string(base++));
-        ip.append(".0");
-        address.SetBase(ip.c_str(), "255.255.255.0");
-        router_level_one_interface[i] = address.Assign(router_level_one_devices[i]);
-    }
+    star_topology topology;
+    topology.lan_helper().SetChannelAttribute("DataRate", ns3::StringValue("50Mbps"));
+    topology.join(lan_client);
 
-    // 为二层路由设置 IP 地址
-    base = 150;
-    ns3::Ipv4InterfaceContainer router_level_two_interface[bs_size];
-    for (i = 0; i < bs_size; ++i) {
-        std::string ip{ "10.1." };
-        ip.append(std::to_string(base++));
-        ip.append(".0");
-        address.SetBase(ip.c_str(), "255.255.255.0");
-        router_level_two_interface[i] = address.Assign(router_level_two_devices[i]);
+    topology.lan_helper().SetChannelAttribute("DataRate", ns3::StringValue("100Mbps"));
+    for (std::size_t i = 0; i < base_stations.size(); ++i) {
+        ns3::NodeContainer lan_bs;
+        base_stations[i]->get_nodes(lan_bs); // 基站节点在前，作为网关
+        topology.attach(lan_bs);
     }
 
-    // For routers to be able to forward packets, they need to have routing rules.
-    ns3::Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    topology.join(lan_cloud);
 }
 
 } // namespace okec
@@ -0,0 +1,221 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_TOPOLOGY_BUILDER_HPP_
+#define OKEC_TOPOLOGY_BUILDER_HPP_
+
+#include <okec/utils/format_helper.hpp>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+namespace okec
+{
+
+struct subnet {
+    ns3::Ipv4Address network;
+    ns3::Ipv4Mask mask;
+};
+
+
+// Hands out non-overlapping subnets from an address pool. Each subnet is
+// aligned to its own size, so subnets of different sizes never overlap.
+class subnet_allocator {
+public:
+    subnet_allocator(const char* base, std::uint32_t prefix_length)
+        : next_{ ns3::Ipv4Address(base).Get() }
+        , end_{ next_ + block_size(prefix_length) } {
+    }
+
+    auto allocate(std::uint32_t prefix_length) -> subnet {
+        auto size = block_size(prefix_length);
+        auto first = (next_ + size - 1) & ~(size - 1);
+        if (first < next_ || first + size > end_ || first + size < first)
+            throw std::length_error(okec::format("address pool exhausted by a /{} subnet", prefix_length));
+
+        next_ = first + size;
+        return { ns3::Ipv4Address(static_cast<std::uint32_t>(first)),
+                 ns3::Ipv4Mask(okec::format("/{}", prefix_length).c_str()) };
+    }
+
+    // The smallest subnet holding `hosts` addresses besides the network and
+    // broadcast ones.
+    auto allocate_for(std::size_t hosts) -> subnet {
+        auto bits = std::bit_width(hosts + 1);
+        return allocate(32 - static_cast<std::uint32_t>(std::max<std::size_t>(bits, 2)));
+    }
+
+private:
+    static auto block_size(std::uint32_t prefix_length) -> std::uint64_t {
+        return std::uint64_t{ 1 } << (32 - std::min(prefix_length, 32u));
+    }
+
+private:
+    std::uint64_t next_;
+    std::uint64_t end_;
+};
+
+
+// Every LAN hangs off one core router, either through its own gateway and
+// uplink, or by sharing a segment with the core:
+//
+//   LAN hosts --csma-- gateway --p2p-- core --csma-- LAN hosts
+//
+// Each attached LAN has its own uplink, so the LANs joined to the core reach
+// it over one p2p hop at that uplink's full rate.
+//
+// Routes are installed statically while building: hosts default to their
+// gateway or the core, gateways default to the core, and the core has one
+// route per attached LAN.
+// Nothing is left for Ipv4GlobalRoutingHelper::PopulateRoutingTables(), whose
+// cost grows super-linearly with the number of routers.
+class star_topology {
+public:
+    star_topology()
+        : lans_{ "10.128.0.0", 10 }
+        , links_{ "10.192.0.0", 10 } {
+        core_ = ns3::CreateObject<ns3::Node>();
+
+        lan_helper_.SetChannelAttribute("DataRate", ns3::StringValue("100Mbps"));
+        lan_helper_.SetChannelAttribute("Delay", ns3::TimeValue(ns3::NanoSeconds(6560)));
+        uplink_helper_.SetDeviceAttribute("DataRate", ns3::StringValue("10Mbps"));
+        uplink_helper_.SetChannelAttribute("Delay", ns3::StringValue("2ms"));
+    }
+
+    // Link attributes apply to the LANs and uplinks attached afterwards.
+    auto lan_helper() -> ns3::CsmaHelper& {
+        return lan_helper_;
+    }
+
+    auto uplink_helper() -> ns3::PointToPointHelper& {
+        return uplink_helper_;
+    }
+
+    auto core() const -> ns3::Ptr<ns3::Node> {
+        return core_;
+    }
+
+    // Connects `lan` to the core through `gateway`, by default its first node.
+    // A gateway that is not part of the LAN joins it.
+    auto attach(ns3::NodeContainer lan, ns3::Ptr<ns3::Node> gateway = nullptr) -> void {
+        if (!gateway) {
+            gateway = lan.Get(0);
+        } else if (!contains(lan, gateway)) {
+            lan.Add(gateway);
+        }
+
+        install_stack(lan);
+        install_stack(core_);
+
+        auto lan_devices = lan_helper_.Install(lan);
+        auto lan_subnet = lans_.allocate_for(lan.GetN());
+        ns3::Ipv4AddressHelper address;
+        address.SetBase(lan_subnet.network, lan_subnet.mask);
+        auto lan_interfaces = address.Assign(lan_devices);
+
+        auto uplink_devices = uplink_helper_.Install(gateway, core_);
+        auto link_subnet = links_.allocate(30);
+        address.SetBase(link_subnet.network, link_subnet.mask);
+        auto uplink_interfaces = address.Assign(uplink_devices);
+
+        ns3::Ipv4StaticRoutingHelper routing;
+        ns3::Ipv4Address gateway_address;
+        for (std::uint32_t i = 0; i < lan.GetN(); ++i) {
+            if (lan.Get(i) == gateway)
+                gateway_address = lan_interfaces.GetAddress(i);
+        }
+
+        for (std::uint32_t i = 0; i < lan.GetN(); ++i) {
+            auto node = lan.Get(i);
+            if (node == gateway)
+                continue;
+
+            auto ipv4 = node->GetObject<ns3::Ipv4>();
+            routing.GetStaticRouting(ipv4)->SetDefaultRoute(gateway_address,
+                ipv4->GetInterfaceForDevice(lan_devices.Get(i)));
+        }
+
+        auto gateway_ipv4 = gateway->GetObject<ns3::Ipv4>();
+        routing.GetStaticRouting(gateway_ipv4)->SetDefaultRoute(uplink_interfaces.GetAddress(1),
+            gateway_ipv4->GetInterfaceForDevice(uplink_devices.Get(0)));
+
+        auto core_ipv4 = core_->GetObject<ns3::Ipv4>();
+        routing.GetStaticRouting(core_ipv4)->AddNetworkRouteTo(lan_subnet.network, lan_subnet.mask,
+            uplink_interfaces.GetAddress(0), core_ipv4->GetInterfaceForDevice(uplink_devices.Get(1)));
+
+        subnets_.push_back(lan_subnet);
+    }
+
+    // Puts the core on `lan` itself; its hosts default to the core.
+    auto join(ns3::NodeContainer lan) -> void {
+        lan.Add(core_);
+        install_stack(lan);
+
+        auto lan_devices = lan_helper_.Install(lan);
+        auto lan_subnet = lans_.allocate_for(lan.GetN());
+        ns3::Ipv4AddressHelper address;
+        address.SetBase(lan_subnet.network, lan_subnet.mask);
+        auto lan_interfaces = address.Assign(lan_devices);
+
+        ns3::Ipv4StaticRoutingHelper routing;
+        auto core_address = lan_interfaces.GetAddress(lan.GetN() - 1);
+        for (std::uint32_t i = 0; i + 1 < lan.GetN(); ++i) {
+            auto ipv4 = lan.Get(i)->GetObject<ns3::Ipv4>();
+            routing.GetStaticRouting(ipv4)->SetDefaultRoute(core_address,
+                ipv4->GetInterfaceForDevice(lan_devices.Get(i)));
+        }
+
+        subnets_.push_back(lan_subnet);
+    }
+
+    // The subnets of the attached and joined LANs, in that order.
+    auto subnets() const -> const std::vector<subnet>& {
+        return subnets_;
+    }
+
+private:
+    static auto contains(const ns3::NodeContainer& nodes, ns3::Ptr<ns3::Node> node) -> bool {
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+            if (*it == node)
+                return true;
+        }
+        return false;
+    }
+
+    static auto install_stack(ns3::NodeContainer nodes) -> void {
+        ns3::InternetStackHelper stack;
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+            if (!(*it)->GetObject<ns3::Ipv4>())
+                stack.Install(*it);
+        }
+    }
+
+private:
+    ns3::Ptr<ns3::Node> core_;
+    ns3::CsmaHelper lan_helper_;
+    ns3::PointToPointHelper uplink_helper_;
+    subnet_allocator lans_;
+    subnet_allocator links_;
+    std::vector<subnet> subnets_;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_TOPOLOGY_BUILDER_HPP_
@@ -11,14 +11,20 @@
 #ifndef OKEC_UDP_APPLICATION_H_
 #define OKEC_UDP_APPLICATION_H_
 
+#include <okec/common/device_address.h>
 #include <okec/common/message_handler.hpp>
 #include <ns3/application.h>
 #include <ns3/socket.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 
 namespace okec
 {
 
+class link_model;
+
 class udp_application : public ns3::Application
 {
 public:
@@ -41,6 +47,12 @@ public:
 
     auto dispatch(std::string_view msg_type, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) -> void;
 
+    // Fast network mode: write() hands messages between applications through
+    // the event scheduler after the latency of `model`, bypassing the sockets
+    // and the ns-3 packet stack. Null switches back to the full ns-3 stack.
+    static auto set_link_model(std::shared_ptr<link_model> model) -> void;
+    static auto get_link_model() -> std::shared_ptr<link_model>;
+
 private:
     auto StartApplication() -> void override;
     auto StopApplication() -> void override;
@@ -48,11 +60,19 @@ private:
     // 获取当前IPv4地址
     static auto get_socket_address(ns3::Ptr<ns3::Socket> socket) -> ns3::Ipv4Address;
 
+    auto receive(ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+
+    // [ip:port, application], the started applications fast mode delivers to
+    static auto endpoints() -> std::unordered_map<device_address, udp_application*>&;
+
 private:
     uint16_t m_port;
     ns3::Ptr<ns3::Socket> m_recv_socket;
     ns3::Ptr<ns3::Socket> m_send_socket;
     message_handler<callback_type> m_msg_handler;
+    std::vector<device_address> m_endpoints; // one per interface address
+
+    static inline std::shared_ptr<link_model> s_link_model;
 };
 
 
@@ -14,7 +14,10 @@
 #include <okec/algorithms/classic/worst_fit_decision_engine.h>
 #include <okec/algorithms/classic/cloud_edge_end_default_decision_engine.h>
 #include <okec/algorithms/machine_learning/DQN_decision_engine.h>
+#include <okec/common/checkpoint.h>
+#include <okec/common/scenario.h>
 #include <okec/common/simulator.h>
+#include <okec/devices/client_population.h>
 #include <okec/mobility/ap_sta_mobility.hpp>
 #include <okec/network/multiple_and_single_LAN_WLAN_network_model.hpp>
 #include <okec/network/multiple_LAN_WLAN_network_model.hpp>
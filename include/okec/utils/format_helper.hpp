@@ -11,9 +11,11 @@
 #ifndef OKEC_FORMAT_HELPER_HPP_
 #define OKEC_FORMAT_HELPER_HPP_
 
+#include <okec/common/device_address.h>
 #include <okec/common/resource.h>
 #include <okec/common/response.h>
 #include <okec/common/task.h>
+#include <algorithm>
 #include <format>
 #include <iostream>
 #include <ns3/ipv4.h>
@@ -61,11 +63,44 @@ struct std::formatter<ns3::Ipv4Address> {
 
     template <typename FormatContext>
     auto format(const ns3::Ipv4Address& ipv4Address, FormatContext& ctx) const {
-        std::ostringstream oss;
-        uint32_t address = ipv4Address.Get();
-        oss << ((address >> 24) & 0xff) << "." << ((address >> 16) & 0xff) << "."
-            << ((address >> 8) & 0xff) << "." << ((address >> 0) & 0xff);
-        return std::vformat_to(ctx.out(), "{}", std::make_format_args(okec::unmove(oss.str())));
+        char text[okec::device_address::max_ip_chars];
+        auto end = okec::device_address(ipv4Address).ip_to_chars(text);
+        return std::ranges::copy(text, end, ctx.out()).out;
+    }
+};
+
+
+// formatting okec::device_address as "ip:port"
+template <>
+struct std::formatter<okec::device_address> {
+    constexpr auto parse(format_parse_context& ctx) {
+        auto it = ctx.begin(), end = ctx.end();
+        if (it != end && *it != '}') throw std::format_error("invalid device_address format");
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format(const okec::device_address& address, FormatContext& ctx) const {
+        char text[okec::device_address::max_ip_chars];
+        auto out = std::ranges::copy(text, address.ip_to_chars(text), ctx.out()).out;
+        return std::format_to(out, ":{}", address.port);
+    }
+};
+
+
+// formatting okec::task_id
+template <>
+struct std::formatter<okec::task_id> {
+    constexpr auto parse(format_parse_context& ctx) {
+        auto it = ctx.begin(), end = ctx.end();
+        if (it != end && *it != '}') throw std::format_error("invalid task_id format");
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format(const okec::task_id& id, FormatContext& ctx) const {
+        char digits[okec::task_id::digits];
+        return std::ranges::copy(digits, id.to_chars(digits), ctx.out()).out;
     }
 };
 
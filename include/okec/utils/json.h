@@ -0,0 +1,38 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_JSON_H_
+#define OKEC_JSON_H_
+
+#include <okec/utils/memory_arena.h>
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+
+using json = nlohmann::json;
+
+
+namespace okec
+{
+
+// nlohmann::json whose objects, arrays, strings and map/vector storage come
+// from the simulation's memory arena. Character data of long strings still
+// lives on the heap. Only the trees okec keeps internally (tasks, messages,
+// responses, the device cache) use it; values handed to or taken from users
+// are plain json, which converts to and from arena_json implicitly.
+using arena_json = nlohmann::basic_json<std::map, std::vector, std::string, bool,
+                                        std::int64_t, std::uint64_t, double, arena_allocator>;
+
+} // namespace okec
+
+#endif // OKEC_JSON_H_
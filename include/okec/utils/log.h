@@ -128,7 +128,7 @@ inline auto error(std::format_string<Args...>&& fmt, Args&&... args)
 inline auto indent_size() -> std::size_t {
     constexpr std::string_view time_format = "[+{:.8f}s] ";
     constexpr std::string_view solid_square_format = "\u2588 ";
-    return std::formatted_size(time_format, ns3::Simulator::Now().GetSeconds()) +
+    return std::formatted_size(time_format, okec::now::seconds()) +
            std::formatted_size(solid_square_format);;
 }
 
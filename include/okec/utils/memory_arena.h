@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_MEMORY_ARENA_H_
+#define OKEC_MEMORY_ARENA_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+
+
+namespace okec
+{
+
+enum class memory_subsystem : std::uint8_t {
+    other,
+    task,
+    message,
+    response,
+    device_cache,
+    count
+};
+
+
+// Pooled storage for the JSON trees of one simulation. The simulator opens an
+// arena on its thread and closes it when destroyed; values allocated in the
+// meantime are carved from size-class pools instead of the global heap. A
+// closed arena lives on until its last block is returned, so values may
+// outlive the simulator. Blocks must be freed on the thread that opened the
+// arena; other threads, and the time before an arena is opened, use the heap.
+class memory_arena
+{
+public:
+    struct usage {
+        std::size_t allocated{};   // bytes, in total
+        std::size_t live{};        // bytes
+        std::size_t peak{};        // bytes
+        std::size_t allocations{};
+    };
+
+public:
+    memory_arena(const memory_arena&) = delete;
+    memory_arena& operator=(const memory_arena&) = delete;
+
+    // Opens an arena and makes it the current one of the calling thread.
+    static auto open() -> memory_arena*;
+
+    // Stops allocating from the arena. Arenas may be closed in any order; the
+    // current one falls back to the most recently opened arena still open.
+    // Must be called on the thread that opened the arena.
+    auto close() -> void;
+
+    static auto current() -> memory_arena*;
+
+    static auto allocate(std::size_t bytes) -> void*;
+    static auto deallocate(void* p, std::size_t bytes) noexcept -> void;
+
+    auto stats(memory_subsystem subsystem) const -> const usage&;
+    auto print_stats() const -> void;
+
+    static auto name(memory_subsystem subsystem) -> std::string_view;
+
+private:
+    memory_arena() = default;
+    ~memory_arena() = default;
+
+    auto release(void* block, std::size_t bytes, memory_subsystem subsystem) noexcept -> void;
+
+private:
+    std::pmr::unsynchronized_pool_resource pool_;
+    std::array<usage, static_cast<std::size_t>(memory_subsystem::count)> usage_{};
+    std::size_t blocks_{};
+    memory_arena* previous_{};   // neighbours in the chain of open arenas
+    memory_arena* next_{};
+    bool closed_{};
+};
+
+
+// Attributes the allocations made while alive to `subsystem`.
+class memory_scope
+{
+public:
+    explicit memory_scope(memory_subsystem subsystem) noexcept;
+    ~memory_scope();
+
+    memory_scope(const memory_scope&) = delete;
+    memory_scope& operator=(const memory_scope&) = delete;
+
+    static auto current() noexcept -> memory_subsystem;
+
+private:
+    memory_subsystem previous_;
+};
+
+
+// Stateless allocator over the current arena, the AllocatorType of arena_json.
+template <typename T>
+struct arena_allocator
+{
+    using value_type = T;
+
+    arena_allocator() noexcept = default;
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U>&) noexcept {}
+
+    auto allocate(std::size_t n) -> T* {
+        static_assert(alignof(T) <= 16, "arena blocks are 16-byte aligned");
+        return static_cast<T*>(memory_arena::allocate(n * sizeof(T)));
+    }
+
+    auto deallocate(T* p, std::size_t n) noexcept -> void {
+        memory_arena::deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    friend auto operator==(const arena_allocator&, const arena_allocator<U>&) noexcept -> bool {
+        return true;
+    }
+};
+
+
+} // namespace okec
+
+#endif // OKEC_MEMORY_ARENA_H_
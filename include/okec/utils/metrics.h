@@ -0,0 +1,243 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_METRICS_H_
+#define OKEC_METRICS_H_
+
+#include <okec/common/device_address.h>
+#include <ns3/nstime.h>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+
+namespace okec
+{
+
+class counter
+{
+public:
+    auto inc(std::uint64_t n = 1) -> void { value_ += n; }
+    auto value() const -> std::uint64_t { return value_; }
+    auto reset() -> void { value_ = 0; }
+
+private:
+    std::uint64_t value_{};
+};
+
+
+class gauge
+{
+public:
+    auto set(double v) -> void { value_ = v; }
+    auto add(double v) -> void { value_ += v; }
+    auto value() const -> double { return value_; }
+    auto reset() -> void { value_ = .0; }
+
+private:
+    double value_{};
+};
+
+
+// Log-linear histogram of positive values: every power of two is split into
+// `sub_buckets` linear buckets, so the relative error of a quantile is below
+// 1 / sub_buckets. Buckets are allocated up front; record() does not allocate.
+// Values outside [lowest, highest] are clamped into the first/last bucket.
+class histogram
+{
+public:
+    histogram(double lowest = 1e-9, double highest = 1e6, unsigned sub_buckets = 64);
+
+    auto record(double value) -> void {
+        ++counts_[index(value)];
+        ++count_;
+        sum_ += value;
+        if (value < min_) min_ = value;
+        if (value > max_) max_ = value;
+    }
+
+    // q in [0, 1]. 0 when empty.
+    auto quantile(double q) const -> double;
+
+    auto count() const -> std::uint64_t { return count_; }
+    auto sum() const -> double { return sum_; }
+    auto mean() const -> double { return count_ ? sum_ / count_ : .0; }
+    auto min() const -> double { return count_ ? min_ : .0; }
+    auto max() const -> double { return count_ ? max_ : .0; }
+
+    // Adds the samples of a histogram with the same layout.
+    auto merge(const histogram& other) -> void;
+
+    auto reset() -> void;
+
+private:
+    auto index(double value) const -> std::size_t;
+    auto bucket_value(std::size_t index) const -> double;
+
+private:
+    int min_exponent_;
+    int max_exponent_;
+    unsigned sub_buckets_;
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t count_{};
+    double sum_{};
+    double min_{ std::numeric_limits<double>::infinity() };
+    double max_{ -std::numeric_limits<double>::infinity() };
+};
+
+
+struct metric_labels
+{
+    std::string_view group{};
+    std::string_view device{};
+    std::string_view engine{};
+};
+
+
+// Named, labelled counters, gauges and histograms. Handles stay valid for the
+// life of the registry, so hot paths can keep them; lookups of existing
+// series do not allocate either.
+class metrics_registry
+{
+public:
+    enum class format { csv, json };
+
+    template <typename Metric>
+    struct series
+    {
+        std::string name;
+        std::string group;
+        std::string device;
+        std::string engine;
+        std::unique_ptr<Metric> metric;
+    };
+
+public:
+    static auto instance() -> metrics_registry&;
+
+    static auto enabled() -> bool {
+        return enabled_;
+    }
+
+    auto enable(bool on = true) -> void;
+
+    auto get_counter(std::string_view name, metric_labels labels = {}) -> counter&;
+    auto get_gauge(std::string_view name, metric_labels labels = {}) -> gauge&;
+    auto get_histogram(std::string_view name, metric_labels labels = {}) -> histogram&;
+
+    auto counters() const -> std::vector<const series<counter>*>;
+    auto gauges() const -> std::vector<const series<gauge>*>;
+    auto histograms() const -> std::vector<const series<histogram>*>;
+
+    // All series of `name` merged, whatever their labels.
+    auto merged_histogram(std::string_view name) const -> histogram;
+
+    // Appends a snapshot of every series, stamped with the simulated time.
+    auto snapshot(const std::string& file, format fmt = format::csv) const -> bool;
+
+    // Takes a snapshot every `interval` of simulated time until the simulation stops.
+    auto snapshot_every(ns3::Time interval, std::string file, format fmt = format::csv) -> void;
+
+    // Drops every series, invalidating the handles handed out so far.
+    auto reset() -> void;
+
+    // Bumped by reset(), so that kept handles can tell they are stale.
+    auto generation() const -> std::size_t;
+
+private:
+    using key_type = std::tuple<std::string, std::string, std::string, std::string>;
+    using key_view = std::tuple<std::string_view, std::string_view, std::string_view, std::string_view>;
+
+    struct key_less
+    {
+        using is_transparent = void;
+
+        template <typename L, typename R>
+        auto operator()(const L& lhs, const R& rhs) const -> bool {
+            return key_view{ std::get<0>(lhs), std::get<1>(lhs), std::get<2>(lhs), std::get<3>(lhs) }
+                 < key_view{ std::get<0>(rhs), std::get<1>(rhs), std::get<2>(rhs), std::get<3>(rhs) };
+        }
+    };
+
+    template <typename Metric>
+    using table_type = std::map<key_type, series<Metric>, key_less>;
+
+    template <typename Metric>
+    static auto find_or_create(table_type<Metric>& table, std::string_view name, metric_labels labels) -> Metric&;
+
+    template <typename Metric>
+    static auto list(const table_type<Metric>& table) -> std::vector<const series<Metric>*>;
+
+private:
+    static inline bool enabled_ = false;
+
+    table_type<counter> counters_;
+    table_type<gauge> gauges_;
+    table_type<histogram> histograms_;
+    std::size_t generation_{};
+};
+
+
+// The series a decision engine records per task, labelled with the engine.
+// Handles are looked up once per group or device and reused, so recording
+// does not allocate once every group and device has been seen.
+class engine_metrics
+{
+public:
+    struct dispatch_series
+    {
+        histogram* wait_time;
+        counter* dispatched;
+    };
+
+    struct completion_series
+    {
+        histogram* processing_time;
+        counter* completed;
+    };
+
+public:
+    explicit engine_metrics(std::string_view engine);
+
+    auto dispatch(std::string_view group) -> const dispatch_series&;
+    auto completion(device_address device) -> const completion_series&;
+    auto queue_length() -> gauge&;
+
+private:
+    auto sync() -> void;
+
+    struct string_hash
+    {
+        using is_transparent = void;
+
+        auto operator()(std::string_view text) const noexcept -> std::size_t {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+
+private:
+    std::string_view engine_;
+    std::size_t generation_{ static_cast<std::size_t>(-1) };
+    std::unordered_map<std::string, dispatch_series, string_hash, std::equal_to<>> dispatch_;
+    std::unordered_map<device_address, completion_series> completion_;
+    gauge* queue_length_{};
+};
+
+
+} // namespace okec
+
+#endif // OKEC_METRICS_H_
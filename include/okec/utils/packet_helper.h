@@ -11,11 +11,9 @@
 #ifndef OKEC_PACKET_HELPER_H_
 #define OKEC_PACKET_HELPER_H_
 
-#include <string_view>
-#include <nlohmann/json.hpp>
+#include <okec/utils/json.h>
 #include <ns3/packet.h>
-
-using json = nlohmann::json;
+#include <string_view>
 
 namespace okec {
 
@@ -29,8 +27,14 @@ auto make_packet(std::string_view sv) -> ns3::Ptr<ns3::Packet>;
 // convert packet to string
 auto to_string(ns3::Ptr<ns3::Packet> packet) -> std::string;
 
-// 
-auto to_json(ns3::Ptr<ns3::Packet> packet) -> json;
+// Null when the packet does not hold JSON text. okec's own trees parse
+// straight into arena_json with to_json<arena_json>().
+template <typename Json = json>
+auto to_json(ns3::Ptr<ns3::Packet> packet) -> Json
+{
+    auto data = to_string(packet);
+    return Json::accept(data) ? Json::parse(data) : Json{};
+}
 
 
 } // namespace packet_helper
@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_PROFILER_H_
+#define OKEC_PROFILER_H_
+
+#include <ns3/nstime.h>
+#include <ns3/simulator.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <queue>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace okec
+{
+
+// Wall-time profiler of message handlers and OKEC-scheduled events.
+// Disabled by default; see simulator::enable_profiler().
+class profiler
+{
+public:
+    struct entry
+    {
+        std::uint64_t count{};
+        double total_seconds{};
+        double max_seconds{};
+    };
+
+    // Times the enclosing block under `category`/`name`. Scopes nest, and the
+    // nesting becomes the stack of the flame graph.
+    class scope
+    {
+    public:
+        scope(std::string_view category, std::string_view name);
+        ~scope();
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+    private:
+        bool active_;
+    };
+
+public:
+    static auto instance() -> profiler&;
+
+    static auto enabled() -> bool {
+        return enabled_;
+    }
+
+    auto enable(bool on = true) -> void;
+
+    // An OKEC event due `delay` from now was scheduled.
+    auto on_schedule(ns3::Time delay) -> void;
+
+    // [category/name, statistics]
+    auto entries() const -> const std::map<std::string, entry>&;
+
+    // [simulated seconds, OKEC events pending]. Cancelled events count as
+    // pending until their due time.
+    auto queue_depth() const -> const std::vector<std::pair<double, std::size_t>>&;
+
+    auto print_table() const -> void;
+
+    // One "frame;frame;frame microseconds" line per stack, self time only,
+    // as read by flamegraph.pl and speedscope.
+    auto write_folded(const std::string& file) const -> bool;
+
+    auto reset() -> void;
+
+private:
+    struct frame
+    {
+        std::string key;
+        std::chrono::steady_clock::time_point start;
+        double child_seconds{};
+    };
+
+    auto push(std::string key) -> void;
+    auto pop() -> void;
+    auto sample_depth() -> void;
+
+private:
+    static inline bool enabled_ = false;
+
+    std::map<std::string, entry> entries_;
+    std::map<std::string, double> folded_; // [stack, self seconds]
+    std::vector<frame> stack_;
+    std::priority_queue<double, std::vector<double>, std::greater<double>> due_;
+    std::vector<std::pair<double, std::size_t>> depth_;
+};
+
+
+// Call site of an OKEC-scheduled event; converting from ns3::Time at the call
+// captures where schedule() was called from.
+struct scheduled_at
+{
+    scheduled_at(ns3::Time delay, std::source_location location = std::source_location::current())
+        : delay{ delay }, location{ location }
+    {
+    }
+
+    ns3::Time delay;
+    std::source_location location;
+};
+
+auto callsite_name(const std::source_location& location) -> std::string;
+
+// ns3::Simulator::Schedule that the profiler can see.
+template <typename Fn, typename... Args>
+auto schedule(scheduled_at when, Fn&& fn, Args&&... args) -> ns3::EventId
+{
+    if (!profiler::enabled())
+        return ns3::Simulator::Schedule(when.delay, std::forward<Fn>(fn), std::forward<Args>(args)...);
+
+    profiler::instance().on_schedule(when.delay);
+    return ns3::Simulator::Schedule(when.delay,
+        [name = callsite_name(when.location), fn = std::forward<Fn>(fn), ...args = std::forward<Args>(args)]() mutable {
+            profiler::scope s{ "event", name };
+            std::invoke(fn, args...);
+        });
+}
+
+
+} // namespace okec
+
+#endif // OKEC_PROFILER_H_
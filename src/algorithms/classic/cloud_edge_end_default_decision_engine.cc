@@ -1,4 +1,5 @@
 #include <okec/algorithms/classic/cloud_edge_end_default_decision_engine.h>
+#include <okec/common/lifecycle.h>
 #include <okec/common/message.h>
 #include <okec/common/simulator.h>
 #include <okec/devices/base_station.h>
@@ -6,6 +7,7 @@
 #include <okec/devices/cloud_server.h>
 #include <okec/devices/edge_device.h>
 #include <okec/utils/log.h>
+#include <okec/utils/metrics.h>
 #include <okec/utils/random.hpp>
 #include <cmath>
 #include <functional> // bind_front
@@ -45,20 +47,49 @@ cloud_edge_end_default_decision_engine::cloud_edge_end_default_decision_engine(
     // okec::print("cache: \n{}\n", this->cache().dump(4));
 }
 
+cloud_edge_end_default_decision_engine::cloud_edge_end_default_decision_engine(
+    std::vector<client_device_container>* clients_container,
+    base_station_container* base_stations,
+    cloud_server* cloud)
+    : clients_container_{clients_container}
+    , base_stations_{base_stations}
+{
+    // 设置决策设备
+    m_decision_device = base_stations->get(0);
+
+    // 初始化资源缓存信息
+    this->initialize_device(base_stations, cloud);
+
+    // Capture decision message
+    base_stations->set_request_handler(message_decision, std::bind_front(&this_type::on_bs_decision_message, this));
+    base_stations->set_request_handler(message_response, std::bind_front(&this_type::on_bs_response_message, this));
+
+    // Capture es handling message
+    base_stations->set_es_request_handler(message_handling, std::bind_front(&this_type::on_es_handling_message, this));
+
+    // Capture clients response message
+    for (auto& clients : *clients_container) {
+        clients.set_request_handler(message_response, std::bind_front(&this_type::on_clients_reponse_message, this));
+    }
+
+    // Capture cloud handling message
+    cloud->set_request_handler(message_handling, std::bind_front(&this_type::on_cloud_handling_message, this));
+}
+
 auto cloud_edge_end_default_decision_engine::make_decision(
     const task_element &header) -> result_t
 {
     // 获取边缘设备数据
-    auto edge_cache = this->cache().data();
-    edge_cache.erase(std::remove_if(edge_cache.begin(), edge_cache.end(), [](const device_cache::value_type& item) {
-        return item["device_type"] == "cs";
-    }));
-    // okec::print("edge cache: {}\n", edge_cache.dump(2));
-
-    auto edge_max = *std::max_element(edge_cache.begin(), edge_cache.end(), 
-        [](const device_cache::value_type& lhs, const device_cache::value_type& rhs) {
-            return TO_DOUBLE(lhs["cpu"]) < TO_DOUBLE(rhs["cpu"]);
-        });
+    // Edge cpu is a processing rate here rather than a reservation, so only the
+    // other schema dimensions have to fit; with the default schema this is the
+    // server with the most cpu.
+    auto& schema = resource_schema::instance();
+    auto demand = schema.demand(header);
+    if (auto cpu = schema.index_of("cpu"))
+        demand[*cpu] = 0.0;
+
+    auto target = this->place(demand);
+    device_cache::value_type edge_max = target != this->cache().end() ? *target : device_cache::value_type{ { "cpu", "0" } };
     // okec::print("edge max: {}\n", TO_STR(edge_max["ip"]));
 
     double cpu_demand = std::stod(header.get_header("cpu"));
@@ -83,7 +114,7 @@ auto cloud_edge_end_default_decision_engine::make_decision(
             return {
                 { "ip", edge_max["ip"] },
                 { "port", edge_max["port"] },
-                { "cpu_supply", std::to_string(cpu_supply) },
+                { "cpu_supply", edge_max["cpu"] },
                 { "type", "es" },
                 { "wait_time", std::to_string(wait_time) }
             };
@@ -96,19 +127,17 @@ auto cloud_edge_end_default_decision_engine::make_decision(
     });
     if (it != this->cache().end()) {
         const auto& device = *it;
+        auto row = static_cast<std::size_t>(it - this->cache().begin());
+        auto& paths = this->paths();
 
-        double cs_x = TO_DOUBLE(device["pos_x"]);
-        double cs_y = TO_DOUBLE(device["pos_y"]);
-        double cs_z = TO_DOUBLE(device["pos_z"]);
         double cloud_cpu_supply = TO_DOUBLE(device["cpu"]);
         double processing_time = cpu_demand / cloud_cpu_supply;
 
-        double b2c_distance = this->calculate_distance(cs_x, cs_y, cs_z);
-        double mps_speed = 3000000.0; // 3000km/s
-        double b2c_propagation_delay = b2c_distance / mps_speed;
+        double b2c_distance = paths.distance(row);
+        double b2c_propagation_delay = paths.propagation_delay(row); // 3000km/s
         // 到服务器考虑往返两次的传播时延和网络时延，传输时延由于回来时响应结果非常小，可以忽略不计
         double b2c_bandwidth = 30.0; // 30Mb/s
-        double b2c_transmission_delay = task_size / b2c_bandwidth + b2c_propagation_delay * 2;
+        double b2c_transmission_delay = paths.transmission_delay(row, task_size, b2c_bandwidth);
         double total_delay = processing_time + u2b_transmission_delay + b2c_transmission_delay + wait_time;
         
         // 能够满足时延要求
@@ -142,16 +171,19 @@ auto cloud_edge_end_default_decision_engine::send(
 {
     static double launch_delay = .0; // 0.3;
 
-    client->response_cache().emplace_back({
-        { "task_id", t.get_header("task_id") },
-        { "group", t.get_header("group") },
-        { "finished", "0" }, // 0: unfinished, Y: finished, N: offloading failure
-        { "device_type", "" },
-        { "device_address", "" },
-        { "processing_delay", "" },
-        { "transmission_delay", "" },
-        { "wait_time", "" }
-    });
+    // client_population 自行统计其用户的响应
+    if (!from_population(t)) {
+        client->response_cache().emplace_back({
+            { "task_id", t.get_header("task_id") },
+            { "group", t.get_header("group") },
+            { "finished", "0" }, // 0: unfinished, Y: finished, N: offloading failure
+            { "device_type", "" },
+            { "device_address", "" },
+            { "processing_delay", "" },
+            { "transmission_delay", "" },
+            { "wait_time", "" }
+        });
+    }
 
     // okec::print("Received tasks:\n{}\n", t.j_data().dump(4));
 
@@ -179,7 +211,10 @@ auto cloud_edge_end_default_decision_engine::send(
     auto self = shared_from_base<this_type>();
     auto write = [self, client, channelWidth, txPowerStart, t = std::move(t)]() mutable {
         auto pos = client->get_position();
-        double u2b_distance = self->calculate_distance(pos.x, pos.y, pos.z);
+        const auto bs = self->uplink_for(client.get());
+        double u2b_distance = bs == self->get_decision_device()
+            ? self->calculate_distance(pos)
+            : ns3::CalculateDistance(pos, bs->get_position());
         double task_size = std::stod(t.get_header("size"));
         // double transmission_delay = /*task_size / 30 + */u2b_distance / 200000 + 0.02;
         double channel_gain = 4.11 * std::pow(3 * std::pow(10, 8) / (4 * std::numbers::pi * 915 * std::pow(10, 6) * u2b_distance), 2.8) * rand_rayleigh();
@@ -199,11 +234,17 @@ auto cloud_edge_end_default_decision_engine::send(
         message msg;
         msg.type(message_decision);
         msg.content(t);
-        const auto bs = self->get_decision_device();
-        
-        // client->write(msg.to_packet(), bs->get_address(), bs->get_port());
+
+        // 只记录真正发出的请求
+        if (self->network_dispatch_) {
+            auto& lifecycle = task_lifecycle::instance();
+            lifecycle.mark(t.id(), stage::client_send);
+            lifecycle.set_label(t.id(), label::group, t.get_header("group"));
+            lifecycle.set_label(t.id(), label::engine, "cloud_edge_end");
+            client->write(msg.to_packet(), bs->get_address(), bs->get_port());
+        }
     };
-    ns3::Simulator::Schedule(ns3::Seconds(launch_delay), write);
+    okec::schedule(ns3::Seconds(launch_delay), write);
     // launch_delay += 0.01;
     launch_delay += 1.0;
 
@@ -216,6 +257,12 @@ auto cloud_edge_end_default_decision_engine::initialize() ->void
         clients_->set_decision_engine(shared_from_base<this_type>());
     }
 
+    if (clients_container_) {
+        for (auto& clients : *clients_container_) {
+            clients.set_decision_engine(shared_from_base<this_type>());
+        }
+    }
+
     if (base_stations_) {
         base_stations_->set_decision_engine(shared_from_base<this_type>());
     }
@@ -233,13 +280,27 @@ auto cloud_edge_end_default_decision_engine::handle_next() -> void
     //     log::info("{}", element.dump());
     // }
 
-    if (auto it = std::ranges::find_if(task_sequence, [](auto const& item) {
-        return item.get_header("status") == "0";
+    auto discipline = m_decision_device->get_queue_discipline();
+    if (auto [it, target] = discipline->select(task_sequence, [this](const task_element& item) {
+        return make_decision(item);
     }); it != std::end(task_sequence)) {
-        auto target = make_decision(*it);
         // 决策失败，无法处理任务
         if (target.is_null()) {
             log::error("No device can handle the task({})!", it->get_header("task_id"));
+
+            // 设置了准入控制时，先按退避时间重试，重试无望时才返回失败
+            if (auto controller = m_decision_device->get_admission_controller()) {
+                if (auto delay = controller->defer(*it)) {
+                    m_decision_device->schedule_retry(*delay);
+                } else {
+                    this->reject(m_decision_device.get(), *it);
+                    discipline->on_remove(*it);
+                    task_sequence.erase(it);
+                    this->handle_next();
+                }
+                return;
+            }
+
             message response {
                 { "msgtype", "response" },
                 { "task_id", it->get_header("task_id") },
@@ -250,14 +311,15 @@ auto cloud_edge_end_default_decision_engine::handle_next() -> void
                 { "transmission_delay", "N/A" },
                 { "wait_time", "N/A" }
             };
+            copy_user_id(*it, response);
 
             // it->set_header("status", "1"); // 更改任务分发状态
 
-            auto from_ip = it->get_header("from_ip");
-            auto from_port = it->get_header("from_port");
-            m_decision_device->write(response.to_packet(), ns3::Ipv4Address(from_ip.c_str()), std::stoi(from_port));
+            auto client = reply_address(*it);
+            m_decision_device->write(response.to_packet(), client.ipv4(), client.port);
 
             // 处理过的任务从队列中清除
+            discipline->on_remove(*it);
             task_sequence.erase(it);
 
             // 如果任务列表不为空
@@ -293,10 +355,34 @@ auto cloud_edge_end_default_decision_engine::handle_next() -> void
 
         it->set_header("wait_time", TO_STR(target["wait_time"]));
         it->set_header("status", "1"); // 更改任务分发状态
-        m_decision_device->write(msg.to_packet(), ns3::Ipv4Address(TO_STR(target["ip"]).c_str()), TO_INT(target["port"]));
+        auto& lifecycle = task_lifecycle::instance();
+        lifecycle.mark(it->id(), stage::decision);
+        lifecycle.set_label(it->id(), label::device, TO_STR(target["ip"]));
+        auto& metrics = discipline->metrics();
+        if (metrics.capacity() <= .0) {
+            double capacity{};
+            for (const auto& device : this->cache().view())
+                capacity += TO_DOUBLE(device["cpu"]);
+            metrics.set_capacity(capacity);
+        }
+        double wait_time = now::seconds() - std::stod(it->get_header("arrival_time"));
+        metrics.on_dispatch(wait_time, std::stod(it->get_header("cpu")));
+        if (metrics_registry::enabled()) {
+            const auto& series = metric_series_.dispatch(it->get_header("group"));
+            series.wait_time->record(wait_time);
+            series.dispatched->inc();
+            metric_series_.queue_length().set(task_sequence.size());
+        }
+        auto address = device_cache::address_of(target);
+        m_decision_device->write(msg.to_packet(), address.ipv4(), address.port);
     }
 }
 
+auto cloud_edge_end_default_decision_engine::network_dispatch(bool enabled) -> void
+{
+    network_dispatch_ = enabled;
+}
+
 auto cloud_edge_end_default_decision_engine::on_bs_decision_message(
     base_station *bs,
     ns3::Ptr<ns3::Packet> packet,
@@ -306,9 +392,17 @@ auto cloud_edge_end_default_decision_engine::on_bs_decision_message(
 
     // task_element 为单位
     auto item = okec::task_element::from_msg_packet(packet);
+    task_lifecycle::instance().mark(item.id(), stage::bs_receive);
     item.set_header("status", "0"); // 增加处理状态信息 0: 未处理 1: 已处理
     item.set_header("arrival_time", okec::format("{:.8f}", now::seconds())); // 增加任务到达时间
-    bs->task_sequence(std::move(item));
+    // 上行可能到达离客户端最近的基站，排队与决策仍统一在决策设备上进行
+    auto queue = m_decision_device.get();
+    if (auto controller = queue->get_admission_controller();
+        controller && !controller->admit(item, queue->task_sequence().size())) {
+        this->reject(bs, item);
+        return;
+    }
+    queue->task_sequence(std::move(item));
 
     this->handle_next();
 }
@@ -321,12 +415,14 @@ auto cloud_edge_end_default_decision_engine::on_bs_response_message(
     message msg(packet);
     auto& task_sequence = bs->task_sequence();
 
-    if (auto it = std::ranges::find_if(task_sequence, [&msg](auto const& item) {
-        return item.get_header("task_id") == msg.get_value("task_id");
+    auto id = task_id::parse(msg.get_value("task_id"));
+    if (auto it = std::ranges::find_if(task_sequence, [id](auto const& item) {
+        return item.id() == id;
     }); it != std::end(task_sequence)) {
         msg.attribute("group", it->get_header("group"));
         msg.attribute("transmission_delay", it->get_header("transmission_delay"));
         msg.attribute("wait_time", it->get_header("wait_time"));
+        copy_user_id(*it, msg);
 
         // 记录云服务器的传输时延(都有这个字段，不用单独记录了)
         // auto transmission_delay = it->get_header("transmission_delay");
@@ -334,11 +430,14 @@ auto cloud_edge_end_default_decision_engine::on_bs_response_message(
         //     msg.attribute("transmission_delay", transmission_delay);
         // }
 
-        auto from_ip = (*it).get_header("from_ip");
-        auto from_port = (*it).get_header("from_port");
-        bs->write(msg.to_packet(), ns3::Ipv4Address(from_ip.c_str()), std::stoi(from_port));
+        auto client = reply_address(*it);
+        task_lifecycle::instance().mark(id, stage::bs_forward);
+        bs->write(msg.to_packet(), client.ipv4(), client.port);
+        auto discipline = bs->get_queue_discipline();
+        discipline->metrics().on_release(std::stod(it->get_header("cpu")));
 
         // 处理过的任务从队列中清除
+        discipline->on_remove(*it);
         task_sequence.erase(it);
     }
 
@@ -356,14 +455,15 @@ auto cloud_edge_end_default_decision_engine::on_es_handling_message(
     auto task_id = task_item.get_header("task_id");
 
     log::info("edge server({:ip}) has received a task({}).", es->get_address(), task_id);
+    task_lifecycle::instance().mark(task_id, stage::es_receive);
 
     auto es_resource = es->get_resource();
-    auto cpu_supply = std::stod(es_resource->get_value("cpu"));
+    auto cpu_supply = es_resource->get<double>("cpu");
     auto cpu_demand = std::stod(task_item.get_header("cpu"));
     auto uncertain_cpu_supply = std::stod(msg.get_value("cpu_supply"));
 
     // 存在冲突，需要重新决策
-    if (uncertain_cpu_supply != cpu_supply || cpu_supply < cpu_demand) {
+    if (uncertain_cpu_supply != cpu_supply || cpu_supply < cpu_demand || !this->reserve_dimensions(*es_resource, task_item)) {
         // 需要重新分配
         log::error("Conflict! cpu_demand: {}, cpu_supply: {}, real_supply: {}.", cpu_demand, uncertain_cpu_supply, cpu_supply);
         this->conflict(es, task_item, ipv4_remote, es->get_port());
@@ -371,7 +471,7 @@ auto cloud_edge_end_default_decision_engine::on_es_handling_message(
     }
 
     // 更改CPU资源
-    es_resource->reset_value("cpu", std::to_string(cpu_supply - cpu_demand));
+    es_resource->add("cpu", -cpu_demand);
     this->resource_changed(es, ipv4_remote, es->get_port());
 
     // 处理任务
@@ -381,12 +481,19 @@ auto cloud_edge_end_default_decision_engine::on_es_handling_message(
     log::info("task(id={}) demand: {}, supply: {}, processing_time: {}", task_id, cpu_demand, cpu_supply, processing_time);
 
     auto self = shared_from_base<this_type>();
-    ns3::Simulator::Schedule(ns3::Seconds(processing_time), [self, es, ipv4_remote, task_id, processing_time, cpu_demand]() {
+    auto finish = [self, es, ipv4_remote, task_id, task_item, cpu_demand](double processing_time) {
+        task_lifecycle::instance().mark(task_id, stage::finish);
+
         // 处理完成，释放内存
         auto device_resource = es->get_resource();
-        auto cur_cpu = std::stod(device_resource->get_value("cpu"));
-        device_resource->reset_value("cpu", std::to_string(cur_cpu + cpu_demand));
+        auto cur_cpu = device_resource->add("cpu", cpu_demand) - cpu_demand;
+        self->release_dimensions(*device_resource, task_item);
         auto device_address = okec::format("{:ip}", es->get_address());
+        if (metrics_registry::enabled()) {
+            const auto& series = self->metric_series_.completion(es->get_address());
+            series.processing_time->record(processing_time);
+            series.completed->inc();
+        }
 
         log::info("edge server({}) restores resources: {} --> {:.2f}(demand: {})", device_address, cur_cpu, cur_cpu + cpu_demand, cpu_demand);
 
@@ -400,7 +507,19 @@ auto cloud_edge_end_default_decision_engine::on_es_handling_message(
             { "processing_time", std::to_string(processing_time) }
         };
         es->write(response.to_packet(), ipv4_remote, es->get_port());
-    });
+    };
+
+    // 安装了执行模型时，处理时间由服务器上的竞争决定，任务分到 cpu 时才开始处理
+    if (auto model = es->get_execution_model()) {
+        model->submit(task_id, cpu_demand, [task_id] {
+            task_lifecycle::instance().mark(task_id, stage::start);
+        }, std::move(finish));
+    } else {
+        task_lifecycle::instance().mark(task_id, stage::start);
+        okec::schedule(ns3::Seconds(processing_time), [finish, processing_time]() {
+            finish(processing_time);
+        });
+    }
 }
 
 auto cloud_edge_end_default_decision_engine::on_cloud_handling_message(
@@ -413,18 +532,17 @@ auto cloud_edge_end_default_decision_engine::on_cloud_handling_message(
     message msg(packet);
     auto task_item = msg.get_task_element(); // task_element::from_msg_packet(packet);
     auto task_id = task_item.get_header("task_id");
+    task_lifecycle::instance().mark(task_id, stage::es_receive);
 
     auto cs_resource = cs->get_resource();
-    auto cpu_supply = std::stod(cs_resource->get_value("cpu"));
+    auto cpu_supply = cs_resource->get<double>("cpu");
     auto cpu_demand = std::stod(task_item.get_header("cpu"));
 
     NS_ASSERT_MSG(cpu_supply > 0, "cloud cpu cupply is not greater than 0");
 
-    // 处理任务
-    double processing_time = cpu_demand / cpu_supply;
-    auto self = shared_from_base<this_type>();
-    ns3::Simulator::Schedule(ns3::Seconds(processing_time), [self, cs, ipv4_remote, task_id, processing_time, cpu_demand]() {
-        // 处理完成，释放内存
+    auto finish = [cs, ipv4_remote, task_id](double processing_time) {
+        // 处理完成
+        task_lifecycle::instance().mark(task_id, stage::finish);
         auto device_address = okec::format("{:ip}", cs->get_address());
 
         message response {
@@ -435,7 +553,21 @@ auto cloud_edge_end_default_decision_engine::on_cloud_handling_message(
             { "processing_time", std::to_string(processing_time) }
         };
         cs->write(response.to_packet(), ipv4_remote, cs->get_port());
-    });
+    };
+
+    // 与边缘服务器一样，安装了执行模型时云端任务才相互竞争 cpu；
+    // 否则每个任务独占云端 cpu，与 make_decision 中的估计一致
+    if (auto model = cs->get_execution_model()) {
+        model->submit(task_id, cpu_demand, [task_id] {
+            task_lifecycle::instance().mark(task_id, stage::start);
+        }, std::move(finish));
+    } else {
+        double processing_time = cpu_demand / cpu_supply;
+        task_lifecycle::instance().mark(task_id, stage::start);
+        okec::schedule(ns3::Seconds(processing_time), [finish, processing_time]() {
+            finish(processing_time);
+        });
+    }
 }
 
 auto cloud_edge_end_default_decision_engine::on_clients_reponse_message(
@@ -444,7 +576,10 @@ auto cloud_edge_end_default_decision_engine::on_clients_reponse_message(
     const ns3::Address &remote_address) -> void
 {
     message msg(packet);
+    task_lifecycle::instance().mark(msg.get_value("task_id"), stage::client_receive);
     log::success("{}", msg.dump());
+    if (from_population(msg))
+        return; // 由 client_population 处理
 
     auto it = client->response_cache().find_if([&msg](const response::value_type& item) {
         return item["group"] == msg.get_value("group") && item["task_id"] == msg.get_value("task_id");
@@ -9,13 +9,18 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <okec/algorithms/classic/worst_fit_decision_engine.h>
+#include <okec/common/lifecycle.h>
 #include <okec/common/message.h>
+#include <okec/common/resource_tracer.h>
 #include <okec/common/simulator.h>
 #include <okec/devices/base_station.h>
 #include <okec/devices/client_device.h>
 #include <okec/devices/edge_device.h>
 #include <okec/utils/log.h>
+#include <okec/utils/metrics.h>
 #include <functional> // bind_front
+#include <limits>
+#include <optional>
 
 
 namespace okec {
@@ -72,37 +77,17 @@ worst_fit_decision_engine::worst_fit_decision_engine(
 
 auto worst_fit_decision_engine::make_decision(const task_element& header) -> result_t
 {
-    auto edge_cache = this->cache().data();
-    auto edge_max = *std::max_element(edge_cache.begin(), edge_cache.end(), 
-        [](const device_cache::value_type& lhs, const device_cache::value_type& rhs) {
-            return TO_DOUBLE(lhs["cpu"]) < TO_DOUBLE(rhs["cpu"]);
-        });
-
-    // okec::print("edge max: {}\n", TO_STR(edge_max["ip"]));
-    
-    double cpu_demand = std::stod(header.get_header("cpu"));
-    double cpu_supply = TO_DOUBLE(edge_max["cpu"]);
-    // double tolorable_time = std::stod(header.get_header("deadline"));
-    // If found a avaliable edge server
-    if (cpu_supply >= cpu_demand) {
-        // double processing_time = cpu_demand / cpu_supply;
-
-        // 暂时不考虑 tolerable time
-        // if (processing_time < tolorable_time) {
-        //     return {
-        //         { "ip", edge_max["ip"] },
-        //         { "port", edge_max["port"] },
-        //         { "cpu_supply", std::to_string(cpu_supply) }
-        //     };
-        // }
-        return {
-            { "ip", edge_max["ip"] },
-            { "port", edge_max["port"] },
-            { "cpu_supply", std::to_string(cpu_supply) }
-        };
-    }
-
-    return result_t();
+    // Worst fit by default, across every dimension of the resource schema.
+    auto target = this->place(header);
+    if (target == this->cache().end())
+        return result_t();
+
+    // 直接转发缓存中的文本，与服务器端的数值保持一致
+    return {
+        { "ip", (*target)["ip"] },
+        { "port", (*target)["port"] },
+        { "cpu_supply", (*target)["cpu"] }
+    };
 }
 
 auto worst_fit_decision_engine::local_test(const task_element& header, client_device* client) -> bool
@@ -114,14 +99,17 @@ auto worst_fit_decision_engine::send(task_element t, std::shared_ptr<client_devi
 {
     static double launch_delay = 0.3;
 
-    client->response_cache().emplace_back({
-        { "task_id", t.get_header("task_id") },
-        { "group", t.get_header("group") },
-        { "finished", "0" }, // 0: unfinished, Y: finished, N: offloading failure
-        { "device_type", "" },
-        { "device_address", "" },
-        { "time_consuming", "" }
-    });
+    // client_population 自行统计其用户的响应
+    if (!from_population(t)) {
+        client->response_cache().emplace_back({
+            { "task_id", t.get_header("task_id") },
+            { "group", t.get_header("group") },
+            { "finished", "0" }, // 0: unfinished, Y: finished, N: offloading failure
+            { "device_type", "" },
+            { "device_address", "" },
+            { "time_consuming", "" }
+        });
+    }
 
     // okec::print("Received tasks:\n{}\n", t.j_data().dump(4));
 
@@ -131,11 +119,15 @@ auto worst_fit_decision_engine::send(task_element t, std::shared_ptr<client_devi
     message msg;
     msg.type(message_decision);
     msg.content(t);
-    const auto bs = this->get_decision_device();
-    auto write = [client, bs, content = msg.to_packet()]() {
+    const auto bs = this->uplink_for(client.get());
+    auto write = [client, bs, content = msg.to_packet(), id = t.id(), group = t.get_header("group")]() {
+        auto& lifecycle = task_lifecycle::instance();
+        lifecycle.mark(id, stage::client_send);
+        lifecycle.set_label(id, label::group, group);
+        lifecycle.set_label(id, label::engine, "worst_fit");
         client->write(content, bs->get_address(), bs->get_port());
     };
-    ns3::Simulator::Schedule(ns3::Seconds(launch_delay), write);
+    okec::schedule(ns3::Seconds(launch_delay), write);
     launch_delay += 0.01;
 
     return true;
@@ -160,61 +152,159 @@ auto worst_fit_decision_engine::initialize() -> void
 
 auto worst_fit_decision_engine::handle_next() -> void
 {
+    if (batch_mode_) {
+        this->handle_batch();
+        return;
+    }
+
     auto& task_sequence = m_decision_device->task_sequence();
     // auto& task_sequence_status = m_decision_device->task_sequence_status();
     log::info("handle_next.... current task sequence size: {}", task_sequence.size());
 
-    if (auto it = std::ranges::find_if(task_sequence, [](auto const& item) {
-        return item.get_header("status") == "0";
-    }); it != std::end(task_sequence)) {
-        auto target = make_decision(*it);
-        // 决策失败，无法处理任务
+    auto discipline = m_decision_device->get_queue_discipline();
+    auto [it, target] = discipline->select(task_sequence, [this](const task_element& item) {
+        return make_decision(item);
+    });
+    if (it == std::end(task_sequence))
+        return;
+
+    // 决策失败，无法处理任务
+    if (target.is_null()) {
+        log::info("No device can handle the task({})!", it->get_header("task_id"));
+
+        // 未设置准入控制时，等待资源释放后自动重新尝试
+        if (auto controller = m_decision_device->get_admission_controller()) {
+            if (auto delay = controller->defer(*it)) {
+                m_decision_device->schedule_retry(*delay);
+            } else {
+                this->reject(m_decision_device.get(), *it);
+                discipline->on_remove(*it);
+                task_sequence.erase(it);
+                this->handle_next(); // 继续尝试处理下一个
+            }
+        }
+        return;
+    }
+
+    // 决策成功，可以处理任务
+    this->dispatch(*it, target);
+}
+
+auto worst_fit_decision_engine::dispatch(task_element& item, const result_t& target) -> void
+{
+    message msg;
+    msg.type(message_handling);
+    msg.content(item);
+    msg.attribute("cpu_supply", TO_STR(target["cpu_supply"]));
+    item.set_header("status", "1"); // 更改任务分发状态
+    this->record_dispatch(item);
+    task_lifecycle::instance().set_label(item.id(), label::device, TO_STR(target["ip"]));
+    auto address = device_cache::address_of(target);
+    m_decision_device->write(msg.to_packet(), address.ipv4(), address.port);
+}
+
+auto worst_fit_decision_engine::record_dispatch(const task_element& item) -> void
+{
+    auto& metrics = m_decision_device->get_queue_discipline()->metrics();
+    if (metrics.capacity() <= .0) {
+        double capacity{};
+        for (const auto& device : this->cache().view())
+            capacity += TO_DOUBLE(device["cpu"]);
+        metrics.set_capacity(capacity);
+    }
+
+    task_lifecycle::instance().mark(item.id(), stage::decision);
+
+    double wait_time = now::seconds() - std::stod(item.get_header("arrival_time"));
+    metrics.on_dispatch(wait_time, std::stod(item.get_header("cpu")));
+
+    if (metrics_registry::enabled()) {
+        const auto& series = metric_series_.dispatch(item.get_header("group"));
+        series.wait_time->record(wait_time);
+        series.dispatched->inc();
+        metric_series_.queue_length().set(m_decision_device->task_sequence().size());
+    }
+}
+
+auto worst_fit_decision_engine::batch_mode(bool enabled) -> void
+{
+    batch_mode_ = enabled;
+}
+
+auto worst_fit_decision_engine::handle_batch() -> void
+{
+    auto& task_sequence = m_decision_device->task_sequence();
+    auto discipline = m_decision_device->get_queue_discipline();
+    auto& schema = resource_schema::instance();
+    auto cpu = schema.index_of("cpu");
+
+    // Supplies as this batch leaves them. Placements debit the copy only; the
+    // servers' own resource updates refresh the cache.
+    auto supply = this->cache().matrix();
+
+    std::size_t placed{};
+    for (;;) {
+        // Every discipline returns right after the first successful decision,
+        // so `row` belongs to the selected task.
+        std::optional<std::size_t> row;
+        resource_schema::vector_type demand{};
+        auto [it, target] = discipline->select(task_sequence, [&](const task_element& item) -> result_t {
+            demand = schema.demand(item);
+            row = supply.place(demand, this->get_placement_policy());
+            if (!row)
+                return result_t();
+
+            const auto& device = *(this->cache().begin() + static_cast<std::ptrdiff_t>(*row));
+            return {
+                { "ip", device["ip"] },
+                { "port", device["port"] },
+                // 与服务器端扣减后的数值一致
+                { "cpu_supply", cpu ? okec::format("{}", supply.get(*row, *cpu)) : TO_STR(device["cpu"]) }
+            };
+        });
+        if (it == std::end(task_sequence))
+            break;
+
         if (target.is_null()) {
             log::info("No device can handle the task({})!", it->get_header("task_id"));
 
-            // message response {
-            //     { "msgtype", "response" },
-            //     { "task_id", (*it).get_header("task_id") },
-            //     { "group", (*it).get_header("group") },
-            //     { "device_type", "null" },
-            //     { "device_address", "null" },
-            //     { "processing_time", "null" }
-            // };
-            // auto from_ip = (*it).get_header("from_ip");
-            // auto from_port = (*it).get_header("from_port");
-            // m_decision_device->write(response.to_packet(), Ipv4Address(from_ip.c_str()), std::stoi(from_port));
-            // task_sequence.erase(it); // 处理过的任务从队列中删除，分发失败也是处理过的，只是当前没有设备能够处理该任务
-            // this->handle_next(); // 继续尝试处理下一个
-            
-            // 等个两秒再尝试
-            // Simulator::Schedule(Seconds(2), +[](this_type* self) {
-            //     self->handle_next();
-            // }, this);
-            // 等待资源释放后自动重新尝试
-            return;
+            if (auto controller = m_decision_device->get_admission_controller()) {
+                if (auto delay = controller->defer(*it)) {
+                    m_decision_device->schedule_retry(*delay);
+                } else {
+                    this->reject(m_decision_device.get(), *it);
+                    discipline->on_remove(*it);
+                    task_sequence.erase(it);
+                    continue;
+                }
+            }
+            break;
         }
 
-        // 决策成功，可以处理任务
-        message msg;
-        msg.type(message_handling);
-        msg.content(*it);
-        msg.attribute("cpu_supply", TO_STR(target["cpu_supply"]));
-        it->set_header("status", "1"); // 更改任务分发状态
-        m_decision_device->write(msg.to_packet(), ns3::Ipv4Address(TO_STR(target["ip"]).c_str()), TO_INT(target["port"]));
+        this->dispatch(*it, target);
+        for (std::size_t d = 0; d < supply.dimensions(); ++d)
+            supply.set(*row, d, supply.get(*row, d) - demand[d]);
+        ++placed;
     }
+
+    log::info("handle_next.... placed {} pending tasks in one batch", placed);
 }
 
 auto worst_fit_decision_engine::train(const task &t) -> void
 {
     auto env = std::make_shared<DiscreteEnv>(this->cache(), t);
 
+    auto tracer = std::make_shared<resource_tracer>("./data/wf-discrete-resource_tracer.bin");
+    tracer->convert_on_close("./data/wf-discrete-resource_tracer.csv");
+    env->set_tracer(tracer);
     env->trace_resource();
 
     auto self = shared_from_base<this_type>();
-    env->when_done([self](const task& t_finished, const device_cache& cache) {
+    env->when_done([self, tracer](const task& t_finished, const device_cache& cache) {
         log::success("end of train"); // done
+        tracer->close();
         double total_time = .0f;
-        for (const auto& elem : t_finished.elements()) {
+        for (const auto& elem : t_finished.element_views()) {
             total_time += std::stod(elem.get_header("processing_time"));
         }
         log::success("total processing time: {}", total_time);
@@ -230,8 +320,17 @@ auto worst_fit_decision_engine::on_bs_decision_message(
 {
     // task_element 为单位
     auto item = okec::task_element::from_msg_packet(packet);
+    task_lifecycle::instance().mark(item.id(), stage::bs_receive);
     item.set_header("status", "0"); // 增加处理状态信息 0: 未处理 1: 已处理
-    bs->task_sequence(std::move(item));
+    item.set_header("arrival_time", okec::format("{:.8f}", now::seconds())); // 增加任务到达时间
+    // 上行可能到达离客户端最近的基站，排队与决策仍统一在决策设备上进行
+    auto queue = m_decision_device.get();
+    if (auto controller = queue->get_admission_controller();
+        controller && !controller->admit(item, queue->task_sequence().size())) {
+        this->reject(bs, item);
+        return;
+    }
+    queue->task_sequence(std::move(item));
     
 
     // !!!
@@ -255,15 +354,20 @@ auto worst_fit_decision_engine::on_bs_response_message(
     auto& task_sequence = bs->task_sequence();
     // auto& task_sequence_status = bs->task_sequence_status();
 
-    if (auto it = std::ranges::find_if(task_sequence, [&msg](auto const& item) {
-        return item.get_header("task_id") == msg.get_value("task_id");
+    auto id = task_id::parse(msg.get_value("task_id"));
+    if (auto it = std::ranges::find_if(task_sequence, [id](auto const& item) {
+        return item.id() == id;
     }); it != std::end(task_sequence)) {
         msg.attribute("group", (*it).get_header("group"));
-        auto from_ip = (*it).get_header("from_ip");
-        auto from_port = (*it).get_header("from_port");
-        bs->write(msg.to_packet(), ns3::Ipv4Address(from_ip.c_str()), std::stoi(from_port));
+        copy_user_id(*it, msg);
+        auto client = reply_address(*it);
+        task_lifecycle::instance().mark(id, stage::bs_forward);
+        bs->write(msg.to_packet(), client.ipv4(), client.port);
+        auto discipline = bs->get_queue_discipline();
+        discipline->metrics().on_release(std::stod(it->get_header("cpu")));
 
         // 处理过的任务从队列中清除
+        discipline->on_remove(*it);
         task_sequence.erase(it);
     }
 
@@ -298,14 +402,15 @@ auto worst_fit_decision_engine::on_es_handling_message(
     auto task_id = task_item.get_header("task_id");
 
     log::info("edge server({:ip}) has received a task({}).", es->get_address(), task_id);
+    task_lifecycle::instance().mark(task_id, stage::es_receive);
 
     auto es_resource = es->get_resource();
-    auto cpu_supply = std::stod(es_resource->get_value("cpu"));
+    auto cpu_supply = es_resource->get<double>("cpu");
     auto cpu_demand = std::stod(task_item.get_header("cpu"));
     auto uncertain_cpu_supply = std::stod(msg.get_value("cpu_supply"));
 
     // 存在冲突，需要重新决策
-    if (uncertain_cpu_supply != cpu_supply || cpu_supply < cpu_demand) {
+    if (uncertain_cpu_supply != cpu_supply || cpu_supply < cpu_demand || !this->reserve_dimensions(*es_resource, task_item)) {
         // 需要重新分配
         log::error("Conflict! cpu_demand: {}, cpu_supply: {}, real_supply: {}.", cpu_demand, uncertain_cpu_supply, cpu_supply);
         this->conflict(es, task_item, ipv4_remote, es->get_port());
@@ -313,7 +418,7 @@ auto worst_fit_decision_engine::on_es_handling_message(
     }
 
     // 更改CPU资源
-    es_resource->reset_value("cpu", std::to_string(cpu_supply - cpu_demand));
+    es_resource->add("cpu", -cpu_demand);
     this->resource_changed(es, ipv4_remote, es->get_port());
 
     // 处理任务
@@ -323,12 +428,19 @@ auto worst_fit_decision_engine::on_es_handling_message(
     log::info("task(id={}) demand: {}, supply: {}, processing_time: {}", task_id, cpu_demand, cpu_supply, processing_time);
 
     auto self = shared_from_base<this_type>();
-    ns3::Simulator::Schedule(ns3::Seconds(processing_time), [self, es, ipv4_remote, task_id, processing_time, cpu_demand]() {
+    auto finish = [self, es, ipv4_remote, task_id, task_item, cpu_demand](double processing_time) {
+        task_lifecycle::instance().mark(task_id, stage::finish);
+
         // 处理完成，释放内存
         auto device_resource = es->get_resource();
-        auto cur_cpu = std::stod(device_resource->get_value("cpu"));
-        device_resource->reset_value("cpu", std::to_string(cur_cpu + cpu_demand));
+        auto cur_cpu = device_resource->add("cpu", cpu_demand) - cpu_demand;
+        self->release_dimensions(*device_resource, task_item);
         auto device_address = okec::format("{:ip}", es->get_address());
+        if (metrics_registry::enabled()) {
+            const auto& series = self->metric_series_.completion(es->get_address());
+            series.processing_time->record(processing_time);
+            series.completed->inc();
+        }
 
         log::info("edge server({}) restores resources: {} --> {:.2f}(demand: {})", device_address, cur_cpu, cur_cpu + cpu_demand, cpu_demand);
 
@@ -342,13 +454,28 @@ auto worst_fit_decision_engine::on_es_handling_message(
             { "processing_time", okec::format("{:.9f}", processing_time) }
         };
         es->write(response.to_packet(), ipv4_remote, es->get_port());
-    });
+    };
+
+    // 安装了执行模型时，处理时间由服务器上的竞争决定，任务分到 cpu 时才开始处理
+    if (auto model = es->get_execution_model()) {
+        model->submit(task_id, cpu_demand, [task_id] {
+            task_lifecycle::instance().mark(task_id, stage::start);
+        }, std::move(finish));
+    } else {
+        task_lifecycle::instance().mark(task_id, stage::start);
+        okec::schedule(ns3::Seconds(processing_time), [finish, processing_time]() {
+            finish(processing_time);
+        });
+    }
 }
 
 auto worst_fit_decision_engine::on_clients_reponse_message(
     client_device* client, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void
 {
     message msg(packet);
+    task_lifecycle::instance().mark(msg.get_value("task_id"), stage::client_receive);
+    if (from_population(msg))
+        return; // 由 client_population 处理
 
     auto it = client->response_cache().find_if([&msg](const response::value_type& item) {
         return item["group"] == msg.get_value("group") && item["task_id"] == msg.get_value("task_id");
@@ -443,7 +570,7 @@ auto DiscreteEnv::train_next() -> void
 
             // 资源恢复
             auto self = shared_from_this();
-            ns3::Simulator::Schedule(ns3::Seconds(processing_time), [self, action, cpu_demand]() {
+            okec::schedule(ns3::Seconds(processing_time), [self, action, cpu_demand]() {
                 auto& edge_cache = self->cache_.view();
                 auto& server = edge_cache.at(action);
                 double cur_cpu = TO_DOUBLE(server["cpu"]);
@@ -477,30 +604,26 @@ auto DiscreteEnv::when_done(done_callback_t callback) -> void
     done_fn_ = callback;
 }
 
+auto DiscreteEnv::set_tracer(std::shared_ptr<resource_tracer> tracer) -> void
+{
+    tracer_ = std::move(tracer);
+}
+
 auto DiscreteEnv::trace_resource() -> void
 {
-    static std::ofstream file;
-    if (!file.is_open()) {
-        file.open("./data/wf-discrete-resource_tracer.csv", std::ios::out/* | std::ios::app*/);
-        if (!file.is_open()) {
-            return;
-        }
-    }
+    if (!tracer_)
+        return;
 
-    // for (const auto& item : m_resources) {
-    //     file << okec::format("At time {:.2f}s,{:ip}", Simulator::Now().GetSeconds(), item->get_address());
-    //     for (auto it = item->begin(); it != item->end(); ++it) {
-    //         file << okec::format(",{}: {}", it.key(), it.value());
-    //     }
-    //     file << "\n";
-    // }
-    // file << "\n";
-    file << okec::format("{:.2f}", okec::now::seconds());
+    // Only the edge servers whose cpu changed since the last call are recorded.
     auto& edge_cache = this->cache_.view();
-    for (const auto& edge : edge_cache) {
-        file << "," << TO_DOUBLE(edge["cpu"]);
+    traced_cpu_.resize(edge_cache.size(), std::numeric_limits<double>::quiet_NaN());
+    for (std::size_t i = 0; i < edge_cache.size(); ++i) {
+        auto cpu = TO_DOUBLE(edge_cache[i]["cpu"]);
+        if (cpu != traced_cpu_[i]) {
+            tracer_->record(TO_STR(edge_cache[i]["ip"]), "cpu", cpu);
+            traced_cpu_[i] = cpu;
+        }
     }
-    file << "\n";
 }
 
 } // namespace okec
\ No newline at end of file
@@ -12,16 +12,74 @@
 #include <okec/devices/base_station.h>
 #include <okec/devices/cloud_server.h>
 #include <okec/devices/edge_device.h>
+#include <okec/mobility/spatial_index.hpp>
 #include <okec/utils/format_helper.hpp>
 #include <okec/utils/log.h>
+#include <okec/utils/memory_arena.h>
+#include <okec/utils/metrics.h>
+#include <okec/utils/profiler.h>
 #include <algorithm>
 #include <charconv>
+#include <cmath>
 #include <ranges>
 
 
 namespace okec
 {
 
+namespace {
+
+auto to_number(const json& value, double& result) -> bool
+{
+    if (value.is_number()) {
+        result = value.get<double>();
+        return true;
+    }
+
+    if (!value.is_string())
+        return false;
+
+    const auto& str = value.get_ref<const std::string&>();
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), result);
+    return ec == std::errc{};
+}
+
+// Whether any numeric attribute moved by more than `threshold` (relative to its
+// published value). Attributes that were never published always count.
+auto crossed_threshold(const json& published, const resource& res, double threshold) -> bool
+{
+    for (auto it = res.begin(); it != res.end(); ++it) {
+        if (!published.contains(it.key()))
+            return true;
+
+        double old_value{}, new_value{};
+        if (threshold <= 0
+            || !to_number(published.at(it.key()), old_value)
+            || !to_number(it.value(), new_value))
+            continue;
+
+        if (std::abs(new_value - old_value) > threshold * std::max(std::abs(old_value), 1e-9))
+            return true;
+    }
+
+    return false;
+}
+
+template <typename Json>
+auto parse_address(const Json& item) -> device_address
+{
+    auto text = [&item](const char* key) -> std::string_view {
+        auto it = item.find(key);
+        if (it == item.end() || !it->is_string())
+            return {};
+        return it->template get_ref<const typename Json::string_t&>();
+    };
+
+    return device_address::parse(text("ip"), text("port"));
+}
+
+} // namespace
+
 auto device_cache::begin() -> iterator
 {
     return this->view().begin();
@@ -32,12 +90,12 @@ auto device_cache::end() -> iterator
     return this->view().end();
 }
 
-auto device_cache::cbegin() const -> json::const_iterator
+auto device_cache::cbegin() const -> const_iterator
 {
     return this->cache["device_cache"]["items"].cbegin();
 }
 
-auto device_cache::cend() const -> json::const_iterator
+auto device_cache::cend() const -> const_iterator
 {
     return this->cache["device_cache"]["items"].cend();
 }
@@ -69,6 +127,7 @@ auto device_cache::empty() const -> bool
 
 auto device_cache::emplace_back(attributes_type values) -> void
 {
+    memory_scope scope{ memory_subsystem::device_cache };
     value_type item;
     for (auto [key, value] : values) {
         item[key] = value;
@@ -83,54 +142,348 @@ auto device_cache::find_if(unary_predicate_type pred) -> iterator
     return std::find_if(items.begin(), items.end(), pred);
 }
 
+auto device_cache::find(device_address address) -> iterator
+{
+    if (index_generation_ != generation_)
+        this->rebuild_index();
+
+    auto it = index_.find(address);
+    if (it == index_.end())
+        return this->end();
+
+    // Addresses written through view() are not reported; check the hit.
+    auto item = this->begin() + static_cast<std::ptrdiff_t>(it->second);
+    if (address_of(*item) == address)
+        return item;
+
+    this->rebuild_index();
+    it = index_.find(address);
+    return it != index_.end() ? this->begin() + static_cast<std::ptrdiff_t>(it->second) : this->end();
+}
+
 auto device_cache::sort(binary_predicate_type comp) -> void
 {
     auto& items = this->view();
     std::sort(items.begin(), items.end(), comp);
+    this->touch_all();
 }
 
 auto device_cache::emplace_back(value_type item) -> void
 {
+    bool indexed = index_generation_ == generation_;
+    auto address = address_of(item);
     this->cache["device_cache"]["items"].emplace_back(std::move(item));
+    this->touch_all();
+
+    // Appending keeps the other rows in place, so the index only grows.
+    if (indexed) {
+        index_.try_emplace(address, this->size() - 1);
+        index_generation_ = generation_;
+    }
+}
+
+auto device_cache::address_of(const value_type& item) -> device_address
+{
+    return parse_address(item);
+}
+
+auto device_cache::address_of(const json& item) -> device_address
+{
+    return parse_address(item);
+}
+
+auto device_cache::rebuild_index() -> void
+{
+    index_.clear();
+    const auto& items = this->view();
+    for (std::size_t row = 0; row < items.size(); ++row)
+        index_.try_emplace(address_of(items[row]), row);
+    index_generation_ = generation_;
+}
+
+auto device_cache::matrix() -> const resource_matrix&
+{
+    auto& schema = resource_schema::instance();
+    auto& items = this->view();
+    if (schema_generation_ != schema.generation() || matrix_.rows() != items.size())
+        rebuild_ = true;
+
+    auto refresh = [&](std::size_t row) {
+        matrix_.set_row(row, schema.supply(items[row]));
+        matrix_.set_enabled(row, items[row].value("device_type", "") != "cs");
+    };
+
+    if (rebuild_) {
+        matrix_.resize(items.size(), schema.dimensions());
+        for (std::size_t row = 0; row < items.size(); ++row)
+            refresh(row);
+        schema_generation_ = schema.generation();
+        rebuild_ = false;
+    } else {
+        for (auto row : touched_)
+            refresh(row);
+    }
+    touched_.clear();
+
+    return matrix_;
+}
+
+auto device_cache::touch(iterator it) -> void
+{
+    if (!rebuild_)
+        touched_.push_back(static_cast<std::size_t>(it - this->begin()));
+}
+
+auto device_cache::touch_all() -> void
+{
+    rebuild_ = true;
+    touched_.clear();
+    ++generation_;
+}
+
+auto device_cache::generation() const -> std::size_t
+{
+    return generation_;
+}
+
+decision_engine::~decision_engine()
+{
+    // 节点可能比决策引擎存活更久，断开绑定了 this 的回调
+    for (auto& [mobility, callback] : m_course_traces)
+        mobility->TraceDisconnectWithoutContext("CourseChange", callback);
 }
 
 auto decision_engine::resource_changed(edge_device* es,
     ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void
 {
+    ++m_digest_changes;
+    device_address address{ es->get_address(), es->get_port() };
+    auto& digest = m_digests[address];
+    digest.source = es->get_resource();
+    digest.sender = es->m_udp_application;
+
+    // No coalescing window, publish every change.
+    if (m_digest_interval.IsZero()) {
+        this->publish_digest(address, remote_ip, remote_port);
+        return;
+    }
+
+    // Large changes cannot wait for the window to close.
+    if (crossed_threshold(digest.published, *digest.source, m_digest_threshold)) {
+        digest.pending.Cancel();
+        this->publish_digest(address, remote_ip, remote_port);
+        return;
+    }
+
+    if (!digest.pending.IsRunning()) {
+        auto self = shared_from_this();
+        digest.pending = okec::schedule(m_digest_interval, [self, address, remote_ip, remote_port]() {
+            self->publish_digest(address, remote_ip, remote_port);
+        });
+    }
+}
+
+auto decision_engine::publish_digest(device_address address,
+    ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void
+{
+    auto& digest = m_digests[address];
+    auto es_resource = digest.source;
+
+    // Delta against the last digest
+    json delta = json::object();
+    for (auto it = es_resource->begin(); it != es_resource->end(); ++it) {
+        if (!digest.published.contains(it.key()) || digest.published[it.key()] != it.value()) {
+            delta[it.key()] = it.value();
+            digest.published[it.key()] = it.value();
+        }
+    }
+
+    // Changes inside the window may cancel each other out. The digest still
+    // goes out, empty, since the decision device retries its queue on each one.
     message notify_msg;
     notify_msg.type(message_resource_changed);
-    notify_msg.attribute("ip", okec::format("{:ip}", es->get_address()));
-    notify_msg.attribute("port", std::to_string(es->get_port()));
-    notify_msg.content(*es->get_resource());
-    es->write(notify_msg.to_packet(), remote_ip, remote_port);
+    notify_msg.attribute("ip", okec::format("{:ip}", address.ipv4()));
+    notify_msg.attribute("port", std::to_string(address.port));
+    notify_msg.content(resource(json{ { "resource", std::move(delta) } }));
+    digest.sender->write(notify_msg.to_packet(), remote_ip, remote_port);
+    ++m_digest_sent;
 }
 
 auto decision_engine::conflict(edge_device* es, const task_element& item, ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void
 {
+    // A conflict means the decision device holds a stale view of this server,
+    // so its pending digest goes out ahead of the conflict message.
+    device_address address{ es->get_address(), es->get_port() };
+    if (auto it = m_digests.find(address); it != m_digests.end() && it->second.pending.IsRunning()) {
+        it->second.pending.Cancel();
+        this->publish_digest(address, remote_ip, remote_port);
+    }
+
+    if (metrics_registry::enabled())
+        metrics_registry::instance().get_counter("conflicts").inc();
+
     message conflict_msg;
     conflict_msg.type(message_conflict);
     conflict_msg.content(item);
     es->write(conflict_msg.to_packet(), remote_ip, remote_port);
 }
 
-auto decision_engine::calculate_distance(const ns3::Vector& pos) -> double
+auto decision_engine::reject(base_station* bs, const task_element& item) -> void
+{
+    message response {
+        { "msgtype", "response" },
+        { "task_id", item.get_header("task_id") },
+        { "group", item.get_header("group") },
+        { "device_type", "null" },
+        { "device_address", "N/A" },
+        { "processing_time", "N/A" },
+        { "transmission_delay", "N/A" },
+        { "wait_time", "N/A" }
+    };
+
+    copy_user_id(item, response);
+
+    auto client = reply_address(item);
+    bs->write(response.to_packet(), client.ipv4(), client.port);
+}
+
+auto decision_engine::copy_user_id(const task_element& item, message& response) -> void
+{
+    if (auto user = item.get_header("user_id"); !user.empty())
+        response.attribute("user_id", user);
+}
+
+auto decision_engine::from_population(const task_element& item) -> bool
+{
+    return !item.get_header("user_id").empty();
+}
+
+auto decision_engine::from_population(message& response) -> bool
+{
+    return !response.get_value("user_id").empty();
+}
+
+auto decision_engine::save_state(json&) const -> void
+{
+}
+
+auto decision_engine::restore_state(const json&) -> void
 {
-    ns3::Vector this_pos = m_decision_device->get_position();
-    double delta_x = this_pos.x - pos.x;
-    double delta_y = this_pos.y - pos.y;
-    double delta_z = this_pos.z - pos.z;
+}
+
+auto decision_engine::reply_address(const task_element& item) -> device_address
+{
+    return device_address::parse(item.get_header("from_ip"), item.get_header("from_port"));
+}
 
-    return std::sqrt(delta_x * delta_x + delta_y * delta_y + delta_z * delta_z);
+auto decision_engine::set_resource_digest(ns3::Time interval, double threshold) -> void
+{
+    m_digest_interval = interval;
+    m_digest_threshold = threshold;
+}
+
+auto decision_engine::resource_digest_stats() const -> std::pair<std::size_t, std::size_t>
+{
+    return { m_digest_changes, m_digest_sent };
+}
+
+auto decision_engine::calculate_distance(const ns3::Vector& pos) -> double
+{
+    this->refresh_moving();
+    return m_paths.distance_to_origin(pos);
 }
 
 auto decision_engine::calculate_distance(double x, double y, double z) -> double
 {
-    ns3::Vector this_pos = m_decision_device->get_position();
-    double delta_x = this_pos.x - x;
-    double delta_y = this_pos.y - y;
-    double delta_z = this_pos.z - z;
+    return this->calculate_distance(ns3::Vector(x, y, z));
+}
+
+auto decision_engine::paths() -> const path_table&
+{
+    auto& items = m_device_cache.view();
+    if (m_paths_generation != m_device_cache.generation() || m_paths.size() != items.size()) {
+        // 位置字符串只在这里解析一次
+        m_paths.resize(items.size());
+        for (std::size_t row = 0; row < items.size(); ++row) {
+            m_paths.set_position(row, ns3::Vector(TO_DOUBLE(items[row]["pos_x"]),
+                TO_DOUBLE(items[row]["pos_y"]), TO_DOUBLE(items[row]["pos_z"])));
+        }
+        m_paths_generation = m_device_cache.generation();
+        m_moving_refreshed = ns3::Time{ -1 };
+    }
+
+    this->refresh_moving();
+    return m_paths;
+}
+
+auto decision_engine::track_mobility(ns3::Ptr<ns3::Node> node, device_address address) -> void
+{
+    auto mobility = node->GetObject<ns3::MobilityModel>();
+    if (!mobility || !m_tracked_nodes.insert(node->GetId()).second)
+        return;
+
+    auto callback = ns3::MakeBoundCallback(&decision_engine::on_course_change, this, address);
+    mobility->TraceConnectWithoutContext("CourseChange", callback);
+    m_course_traces.emplace_back(mobility, std::move(callback));
+    this->update_moving(address, mobility);
+}
+
+auto decision_engine::on_course_change(decision_engine* self, device_address address, ns3::Ptr<const ns3::MobilityModel> mobility) -> void
+{
+    self->update_moving(address, mobility);
+
+    auto position = mobility->GetPosition();
+    if (!address) {
+        self->m_paths.set_origin(position);
+        return;
+    }
+
+    auto& cache = self->m_device_cache;
+    auto item = cache.find(address);
+    if (item == cache.end())
+        return;
 
-    return std::sqrt(delta_x * delta_x + delta_y * delta_y + delta_z * delta_z);
+    (*item)["pos_x"] = std::to_string(position.x);
+    (*item)["pos_y"] = std::to_string(position.y);
+    (*item)["pos_z"] = std::to_string(position.z);
+
+    // A stale table is rebuilt from the cache on its next use anyway.
+    auto row = static_cast<std::size_t>(item - cache.begin());
+    if (self->m_paths_generation == cache.generation() && row < self->m_paths.size())
+        self->m_paths.set_position(row, position);
+}
+
+auto decision_engine::update_moving(device_address address, ns3::Ptr<const ns3::MobilityModel> mobility) -> void
+{
+    // CourseChange only fires when the velocity changes, so a device moving
+    // steadily has to be read again whenever positions are used.
+    auto velocity = mobility->GetVelocity();
+    if (velocity.x != .0 || velocity.y != .0 || velocity.z != .0)
+        m_moving[address] = mobility;
+    else
+        m_moving.erase(address);
+}
+
+auto decision_engine::refresh_moving() -> void
+{
+    auto current = ns3::Simulator::Now();
+    if (m_moving.empty() || current == m_moving_refreshed)
+        return;
+    m_moving_refreshed = current;
+
+    bool table_valid = m_paths_generation == m_device_cache.generation();
+    for (const auto& [address, mobility] : m_moving) {
+        auto position = mobility->GetPosition();
+        if (!address) {
+            m_paths.set_origin(position);
+            continue;
+        }
+
+        auto item = m_device_cache.find(address);
+        auto row = static_cast<std::size_t>(item - m_device_cache.begin());
+        if (item != m_device_cache.end() && table_valid && row < m_paths.size())
+            m_paths.set_position(row, position);
+    }
 }
 
 auto decision_engine::initialize_device(base_station_container* bs_container, cloud_server* cs) -> void
@@ -139,10 +492,14 @@ auto decision_engine::initialize_device(base_station_container* bs_container, cl
     if (!m_decision_device)
         m_decision_device = bs_container->get(0);
 
+    m_paths.set_origin(m_decision_device->get_position());
+    this->track_mobility(m_decision_device->get_node(), {});
+
     // 记录云服务器信息
     if (cs) {
         auto cs_pos = cs->get_position();
         auto cs_res = cs->get_resource();
+        this->track_mobility(cs->get_node(), device_address{ cs->get_address(), cs->get_port() });
 
         if (cs_res && !cs_res->empty()) {
             m_device_cache.emplace_back({
@@ -165,7 +522,7 @@ auto decision_engine::initialize_device(base_station_container* bs_container, cl
             log::debug("The decision engine got the resource information of cloud({}).", (*item)["ip"].template get<std::string>());
         } else {
             // 说明设备此时还未绑定资源，通过网络询问一下
-            ns3::Simulator::Schedule(ns3::Seconds(1.0), +[](const std::shared_ptr<base_station> socket, const ns3::Ipv4Address& ip, uint16_t port) {
+            okec::schedule(ns3::Seconds(1.0), +[](const std::shared_ptr<base_station> socket, const ns3::Ipv4Address& ip, uint16_t port) {
                 message msg;
                 msg.type("get_resource_information");
                 socket->write(msg.to_packet(), ip, port);
@@ -179,6 +536,7 @@ auto decision_engine::initialize_device(base_station_container* bs_container, cl
     [&delay, this](const base_station_container::pointer_t bs) {
         for (const auto& device : bs->get_edge_devices()) {
             auto p_resource = device->get_resource();
+            this->track_mobility(device->get_node(), device_address{ device->get_address(), device->get_port() });
 
             // 动态记录资源信息
             if (p_resource && !p_resource->empty()) {
@@ -196,20 +554,18 @@ auto decision_engine::initialize_device(base_station_container* bs_container, cl
                     { "pos_z", std::to_string(es_pos.z) }
                 });
 
-                auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                    return item["ip"] == ip && item["port"] == port;
-                };
-                auto item = m_device_cache.find_if(find_pred);
+                auto item = m_device_cache.find(device_address{ device->get_address(), device->get_port() });
                 if (item != m_device_cache.end()) {
                     for (auto it = p_resource->begin(); it != p_resource->end(); ++it) {
                         (*item)[it.key()] = it.value();
                     }
+                    m_device_cache.touch(item);
                 }
 
                 log::debug("The decision engine got the resource information of edge device({}).", (*item)["ip"].template get<std::string>());
             } else {
                 // 说明设备此时还未绑定资源，通过网络询问一下
-                ns3::Simulator::Schedule(ns3::Seconds(delay), +[](const std::shared_ptr<base_station> socket, const ns3::Ipv4Address& ip, uint16_t port) {
+                okec::schedule(ns3::Seconds(delay), +[](const std::shared_ptr<base_station> socket, const ns3::Ipv4Address& ip, uint16_t port) {
                     message msg;
                     msg.type(message_get_resource_information);
                     socket->write(msg.to_packet(), ip, port);
@@ -240,14 +596,12 @@ auto decision_engine::initialize_device(base_station_container* bs_container, cl
                 { "pos_z", msg.get_value("pos_z") }
             });
 
-            auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                return item["ip"] == ip && item["port"] == port;
-            };
-            auto item = m_device_cache.find_if(find_pred);
+            auto item = m_device_cache.find(device_address::parse(ip, port));
             if (item != m_device_cache.end()) {
                 for (auto it = es_resource.begin(); it != es_resource.end(); ++it) {
                     (*item)[it.key()] = it.value();
                 }
+                m_device_cache.touch(item);
             }
         });
 
@@ -262,14 +616,12 @@ auto decision_engine::initialize_device(base_station_container* bs_container, cl
             auto port = msg.get_value("port");
 
             // 更新资源信息
-            auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                return item["ip"] == ip && item["port"] == port;
-            };
-            auto item = m_device_cache.find_if(find_pred);
+            auto item = m_device_cache.find(device_address::parse(ip, port));
             if (item != m_device_cache.end()) {
                 for (auto it = es_resource.begin(); it != es_resource.end(); ++it) {
                     (*item)[it.key()] = it.value();
                 }
+                m_device_cache.touch(item);
             }
 
             // 继续处理下一个任务的分发
@@ -281,8 +633,8 @@ auto decision_engine::initialize_device(base_station_container* bs_container, cl
         [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
             auto task_item = task_element::from_msg_packet(packet);
             auto& task_sequence = bs->task_sequence();
-            if (auto it = std::ranges::find_if(task_sequence, [&task_item](auto const& item) {
-                return item.get_header("task_id") == task_item.get_header("task_id");
+            if (auto it = std::ranges::find_if(task_sequence, [id = task_item.id()](auto const& item) {
+                return item.id() == id;
             }); it != std::end(task_sequence)) {
                 // okec::print("找到了 {} status: {}\n", (*it).get_header("task_id"), (*it).get_header("status"));
                 (*it).set_header("status", "0");
@@ -297,12 +649,16 @@ auto decision_engine::initialize_device(base_station_container* bs_container) ->
     if (!m_decision_device)
         m_decision_device = bs_container->get(0);
 
+    m_paths.set_origin(m_decision_device->get_position());
+    this->track_mobility(m_decision_device->get_node(), {});
+
     // 记录边缘服务器信息
     double delay = 1.0;
     std::for_each(bs_container->begin(), bs_container->end(),
     [&delay, this](const base_station_container::pointer_t bs) {
         for (const auto& device : bs->get_edge_devices()) {
             auto p_resource = device->get_resource();
+            this->track_mobility(device->get_node(), device_address{ device->get_address(), device->get_port() });
 
             // 动态记录资源信息
             if (p_resource && !p_resource->empty()) {
@@ -320,20 +676,18 @@ auto decision_engine::initialize_device(base_station_container* bs_container) ->
                     { "pos_z", std::to_string(es_pos.z) }
                 });
 
-                auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                    return item["ip"] == ip && item["port"] == port;
-                };
-                auto item = m_device_cache.find_if(find_pred);
+                auto item = m_device_cache.find(device_address{ device->get_address(), device->get_port() });
                 if (item != m_device_cache.end()) {
                     for (auto it = p_resource->begin(); it != p_resource->end(); ++it) {
                         (*item)[it.key()] = it.value();
                     }
+                    m_device_cache.touch(item);
                 }
 
                 log::debug("The decision engine received resource information from edge server({}).", (*item)["ip"].template get<std::string>());
             } else {
                 // 说明设备此时还未绑定资源，通过网络询问一下
-                ns3::Simulator::Schedule(ns3::Seconds(delay), +[](const std::shared_ptr<base_station> socket, const ns3::Ipv4Address& ip, uint16_t port) {
+                okec::schedule(ns3::Seconds(delay), +[](const std::shared_ptr<base_station> socket, const ns3::Ipv4Address& ip, uint16_t port) {
                     message msg;
                     msg.type(message_get_resource_information);
                     socket->write(msg.to_packet(), ip, port);
@@ -364,14 +718,12 @@ auto decision_engine::initialize_device(base_station_container* bs_container) ->
                 { "pos_z", msg.get_value("pos_z") }
             });
 
-            auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                return item["ip"] == ip && item["port"] == port;
-            };
-            auto item = m_device_cache.find_if(find_pred);
+            auto item = m_device_cache.find(device_address::parse(ip, port));
             if (item != m_device_cache.end()) {
                 for (auto it = es_resource.begin(); it != es_resource.end(); ++it) {
                     (*item)[it.key()] = it.value();
                 }
+                m_device_cache.touch(item);
             }
         });
 
@@ -386,14 +738,12 @@ auto decision_engine::initialize_device(base_station_container* bs_container) ->
             auto port = msg.get_value("port");
 
             // 更新资源信息
-            auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                return item["ip"] == ip && item["port"] == port;
-            };
-            auto item = m_device_cache.find_if(find_pred);
+            auto item = m_device_cache.find(device_address::parse(ip, port));
             if (item != m_device_cache.end()) {
                 for (auto it = es_resource.begin(); it != es_resource.end(); ++it) {
                     (*item)[it.key()] = it.value();
                 }
+                m_device_cache.touch(item);
             }
 
             // 继续处理下一个任务的分发
@@ -405,8 +755,8 @@ auto decision_engine::initialize_device(base_station_container* bs_container) ->
         [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
             auto task_item = task_element::from_msg_packet(packet);
             auto& task_sequence = bs->task_sequence();
-            if (auto it = std::ranges::find_if(task_sequence, [&task_item](auto const& item) {
-                return item.get_header("task_id") == task_item.get_header("task_id");
+            if (auto it = std::ranges::find_if(task_sequence, [id = task_item.id()](auto const& item) {
+                return item.id() == id;
             }); it != std::end(task_sequence)) {
                 // okec::print("找到了 {} status: {}\n", (*it).get_header("task_id"), (*it).get_header("status"));
                 (*it).set_header("status", "0");
@@ -420,6 +770,77 @@ auto decision_engine::get_decision_device() const -> std::shared_ptr<base_statio
     return m_decision_device;
 }
 
+auto decision_engine::set_spatial_index(std::shared_ptr<spatial_index> index) -> void
+{
+    m_spatial_index = std::move(index);
+}
+
+auto decision_engine::get_spatial_index() const -> std::shared_ptr<spatial_index>
+{
+    return m_spatial_index;
+}
+
+auto decision_engine::uplink_for(const client_device* client) const -> std::shared_ptr<base_station>
+{
+    if (m_spatial_index) {
+        if (auto cell = m_spatial_index->serving(client))
+            return cell;
+    }
+
+    return m_decision_device;
+}
+
+auto decision_engine::set_placement_policy(placement_policy policy) -> void
+{
+    m_placement_policy = policy;
+}
+
+auto decision_engine::get_placement_policy() const -> placement_policy
+{
+    return m_placement_policy;
+}
+
+auto decision_engine::place(const task_element& item) -> device_cache::iterator
+{
+    return this->place(resource_schema::instance().demand(item));
+}
+
+auto decision_engine::place(const resource_schema::vector_type& demand) -> device_cache::iterator
+{
+    auto row = m_device_cache.matrix().place(demand, m_placement_policy);
+    if (!row)
+        return m_device_cache.end();
+
+    return m_device_cache.begin() + static_cast<std::ptrdiff_t>(*row);
+}
+
+auto decision_engine::reserve_dimensions(resource& res, const task_element& item) -> bool
+{
+    auto& schema = resource_schema::instance();
+    auto demand = schema.demand(item);
+    for (std::size_t d = 0; d < schema.dimensions(); ++d) {
+        if (schema.name(d) != "cpu" && res.get<double>(schema.name(d)) < demand[d])
+            return false;
+    }
+
+    for (std::size_t d = 0; d < schema.dimensions(); ++d) {
+        if (schema.name(d) != "cpu" && demand[d] != 0.0)
+            res.add(schema.name(d), -demand[d]);
+    }
+
+    return true;
+}
+
+auto decision_engine::release_dimensions(resource& res, const task_element& item) -> void
+{
+    auto& schema = resource_schema::instance();
+    auto demand = schema.demand(item);
+    for (std::size_t d = 0; d < schema.dimensions(); ++d) {
+        if (schema.name(d) != "cpu" && demand[d] != 0.0)
+            res.add(schema.name(d), demand[d]);
+    }
+}
+
 auto decision_engine::cache() -> device_cache&
 {
     return m_device_cache;
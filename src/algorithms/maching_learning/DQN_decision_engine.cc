@@ -10,12 +10,16 @@
 
 #include <okec/algorithms/machine_learning/DQN_decision_engine.h>
 #include <okec/common/message.h>
+#include <okec/common/resource_tracer.h>
 #include <okec/devices/base_station.h>
 #include <okec/devices/client_device.h>
 #include <okec/devices/cloud_server.h>
 #include <okec/devices/edge_device.h>
 #include <okec/utils/log.h>
+#include <okec/utils/profiler.h>
 #include <functional> // std::bind_front
+#include <limits>
+#include <sstream>
 
 
 namespace okec
@@ -134,7 +138,7 @@ auto Env::train_next(torch::Tensor observation) -> void
 
             // 资源恢复
             auto self = shared_from_this();
-            ns3::Simulator::Schedule(ns3::Seconds(processing_time), [self, action, cpu_demand, alpha, beta, average_processing_time]() {
+            okec::schedule(ns3::Seconds(processing_time), [self, action, cpu_demand, alpha, beta, average_processing_time]() {
                 auto& edge_cache = self->cache_.view();
                 auto& server = edge_cache.at(action);
                 double cur_cpu = TO_DOUBLE(server["cpu"]);
@@ -214,34 +218,30 @@ auto Env::learn(std::size_t step) -> void
     }
 }
 
+auto Env::set_tracer(std::shared_ptr<resource_tracer> tracer) -> void
+{
+    tracer_ = std::move(tracer);
+}
+
 auto Env::trace_resource(int flag) -> void
 {
-    static std::ofstream file;
-    if (!file.is_open()) {
-        file.open("./data/rf-discrete-resource_tracer.csv", std::ios::out/* | std::ios::app*/);
-        if (!file.is_open()) {
-            return;
-        }
-    }
+    if (!tracer_)
+        return;
 
     if (flag) {
-        file << "\n\n\n\n===================Episode-" + std::to_string(episode) + "===========================\n\n\n\n";
+        tracer_->mark(okec::format("episode {}", episode));
     }
 
-    // for (const auto& item : m_resources) {
-    //     file << okec::format("At time {:.2f}s,{:ip}", Simulator::Now().GetSeconds(), item->get_address());
-    //     for (auto it = item->begin(); it != item->end(); ++it) {
-    //         file << okec::format(",{}: {}", it.key(), it.value());
-    //     }
-    //     file << "\n";
-    // }
-    // file << "\n";
-    file << okec::format("{:.2f} [episode={}]", ns3::Simulator::Now().GetSeconds(), episode);
+    // Only the edge servers whose cpu changed since the last call are recorded.
     auto& edge_cache = this->cache_.view();
-    for (const auto& edge : edge_cache) {
-        file << "," << TO_DOUBLE(edge["cpu"]);
+    traced_cpu_.resize(edge_cache.size(), std::numeric_limits<double>::quiet_NaN());
+    for (std::size_t i = 0; i < edge_cache.size(); ++i) {
+        auto cpu = TO_DOUBLE(edge_cache[i]["cpu"]);
+        if (cpu != traced_cpu_[i]) {
+            tracer_->record(TO_STR(edge_cache[i]["ip"]), "cpu", cpu);
+            traced_cpu_[i] = cpu;
+        }
     }
-    file << "\n";
 }
 
 DQN_decision_engine::DQN_decision_engine(
@@ -310,16 +310,19 @@ auto DQN_decision_engine::send(task_element t, std::shared_ptr<client_device> cl
 {
     static double launch_delay = 1.0;
 
-    client->response_cache().emplace_back({
-        { "task_id", t.get_header("task_id") },
-        { "group", t.get_header("group") },
-        { "finished", "0" }, // 1 indicates finished, while 0 signifies the opposite.
-        { "device_type", "" },
-        { "device_address", "" },
-        { "time_consuming", "" },
-        { "send_time", "" },
-        { "power_consumption", "" }
-    });
+    // client_population 自行统计其用户的响应
+    if (!from_population(t)) {
+        client->response_cache().emplace_back({
+            { "task_id", t.get_header("task_id") },
+            { "group", t.get_header("group") },
+            { "finished", "0" }, // 1 indicates finished, while 0 signifies the opposite.
+            { "device_type", "" },
+            { "device_address", "" },
+            { "time_consuming", "" },
+            { "send_time", "" },
+            { "power_consumption", "" }
+        });
+    }
 
     // 将所有任务都发送到决策设备，从而得到所有任务的信息
     // 追加任务发送地址信息
@@ -332,7 +335,7 @@ auto DQN_decision_engine::send(task_element t, std::shared_ptr<client_device> cl
     auto write = [client, bs, content = msg.to_packet()]() {
         client->write(content, bs->get_address(), bs->get_port());
     };
-    ns3::Simulator::Schedule(ns3::Seconds(launch_delay), write);
+    okec::schedule(ns3::Seconds(launch_delay), write);
     // ns3::Simulator::Schedule(ns3::Seconds(launch_delay), &client_device::write, client, msg.to_packet(), bs->get_address(), bs->get_port());
     launch_delay += 0.1;
 
@@ -341,10 +344,10 @@ auto DQN_decision_engine::send(task_element t, std::shared_ptr<client_device> cl
 
 auto DQN_decision_engine::train(const task& train_task, int episode) -> void
 {
-    auto n_actions = this->cache().size();
-    auto n_features = this->cache().size() + 1; // +1 是 task cpu demand
-    RL = std::make_shared<DeepQNetwork>(n_actions, n_features, 0.01, 0.9, 0.9, 200, 2000, 128, 0.0001);
+    RL = make_network();
 
+    tracer_ = std::make_shared<resource_tracer>("./data/rf-discrete-resource_tracer.bin");
+    tracer_->convert_on_close("./data/rf-discrete-resource_tracer.csv");
 
     train_start(train_task, episode, episode);
 
@@ -445,6 +448,43 @@ auto DQN_decision_engine::handle_next() -> void
     return void();
 }
 
+auto DQN_decision_engine::save_state(json& state) const -> void
+{
+    if (!RL)
+        return;
+
+    std::ostringstream out;
+    torch::save(RL, out);
+    auto bytes = std::move(out).str();
+    state["RL"] = json::binary(std::vector<std::uint8_t>(bytes.begin(), bytes.end()));
+}
+
+auto DQN_decision_engine::restore_state(const json& state) -> void
+{
+    auto it = state.find("RL");
+    if (it == state.end() || !it->is_binary())
+        return;
+
+    // 网络的形状取决于设备数量，缓存需先于此恢复
+    auto network = make_network();
+    const auto& bytes = it->get_binary();
+    std::istringstream in(std::string(bytes.begin(), bytes.end()));
+    try {
+        torch::load(network, in);
+    } catch (const std::exception& e) {
+        log::error("DQN state not restored: {}", e.what());
+        return;
+    }
+    RL = std::move(network);
+}
+
+auto DQN_decision_engine::make_network() -> std::shared_ptr<DeepQNetwork>
+{
+    auto n_actions = this->cache().size();
+    auto n_features = this->cache().size() + 1; // +1 是 task cpu demand
+    return std::make_shared<DeepQNetwork>(n_actions, n_features, 0.01, 0.9, 0.9, 200, 2000, 128, 0.0001);
+}
+
 auto DQN_decision_engine::on_bs_decision_message(
     base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void
 {
@@ -452,6 +492,14 @@ auto DQN_decision_engine::on_bs_decision_message(
     log::debug("The base station[{:ip}] has received the decision request from {:ip}.", bs->get_address(), inetRemoteAddress.GetIpv4());
 
     auto item = okec::task_element::from_msg_packet(packet);
+
+    // The engine decides offline (train_start) and never answers queued tasks.
+    // Logical users count on a response per task, so theirs fail right away.
+    if (from_population(item)) {
+        this->reject(bs, item);
+        return;
+    }
+
     bs->task_sequence(std::move(item));
 
     // bs->print_task_info();
@@ -487,6 +535,10 @@ auto DQN_decision_engine::train_start(const task& train_task, int episode, int e
         auto total_time = std::accumulate(total_times_.begin(), total_times_.end(), .0);
         auto [min, max] = std::ranges::minmax(total_times_);
         log::info("Average total times: {}, min: {}, max: {}", total_time / total_times_.size(), min, max);
+        if (tracer_) {
+            tracer_->close();
+            tracer_.reset();
+        }
         // RL->plot_cost();
         return;
     }
@@ -499,13 +551,14 @@ auto DQN_decision_engine::train_start(const task& train_task, int episode, int e
 
     // 记录初始资源情况
     env->episode = episode_all - episode + 1;
+    env->set_tracer(tracer_);
     env->trace_resource(env->episode);
 
     auto self = shared_from_base<this_type>();
     env->when_done([self, &train_task, episode, episode_all](const task& t, const device_cache& cache) {
         log::debug("train end (episode={})", episode_all - episode + 1);
         double total_time = .0f;
-        for (const auto& elem : t.elements()) {
+        for (const auto& elem : t.element_views()) {
             total_time += std::stod(elem.get_header("processing_time"));
         }
         // t.print();
@@ -0,0 +1,106 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/admission_controller.h>
+#include <okec/common/simulator.h>
+#include <okec/utils/format_helper.hpp>
+#include <okec/utils/log.h>
+#include <cmath>
+
+
+namespace okec
+{
+
+admission_controller::admission_controller(admission_config config)
+    : config_{ config }
+{
+}
+
+auto admission_controller::admit(const task_element& item, std::size_t queue_length) -> bool
+{
+    if (config_.max_queue_length && queue_length >= config_.max_queue_length) {
+        log::warning("task({}) dropped: queue length {} reached the limit.", item.get_header("task_id"), queue_length);
+        ++dropped_;
+        return false;
+    }
+
+    if (auto slack = deadline_slack(item); slack && *slack < config_.min_deadline_slack) {
+        log::warning("task({}) dropped: deadline slack {:.6f}s is too small.", item.get_header("task_id"), *slack);
+        ++dropped_;
+        return false;
+    }
+
+    ++admitted_;
+    return true;
+}
+
+auto admission_controller::defer(task_element& item) -> std::optional<double>
+{
+    double current = now::seconds();
+
+    // A retry is already on its way.
+    if (auto retry_at = item.get_header("retry_at"); !retry_at.empty()) {
+        if (double due = std::stod(retry_at); due > current)
+            return due - current;
+    }
+
+    auto retries_value = item.get_header("retries");
+    std::size_t retries = retries_value.empty() ? 0 : std::stoul(retries_value);
+    if (config_.max_retries && retries >= config_.max_retries) {
+        log::warning("task({}) dropped after {} retries.", item.get_header("task_id"), retries);
+        ++dropped_;
+        return std::nullopt;
+    }
+
+    double delay = config_.retry_delay * std::pow(config_.backoff_factor, static_cast<double>(retries));
+    if (auto slack = deadline_slack(item); slack && *slack - delay < config_.min_deadline_slack) {
+        log::warning("task({}) dropped: it would miss its deadline waiting for a retry.", item.get_header("task_id"));
+        ++dropped_;
+        return std::nullopt;
+    }
+
+    item.set_header("retries", std::to_string(retries + 1));
+    item.set_header("retry_at", okec::format("{:.9f}", current + delay));
+    ++deferred_;
+    return delay;
+}
+
+auto admission_controller::config() const -> const admission_config&
+{
+    return config_;
+}
+
+auto admission_controller::admitted() const -> std::size_t
+{
+    return admitted_;
+}
+
+auto admission_controller::deferred() const -> std::size_t
+{
+    return deferred_;
+}
+
+auto admission_controller::dropped() const -> std::size_t
+{
+    return dropped_;
+}
+
+auto admission_controller::deadline_slack(const task_element& item) const -> std::optional<double>
+{
+    auto deadline = item.get_header("deadline");
+    auto arrival_time = item.get_header("arrival_time");
+    if (deadline.empty() || arrival_time.empty())
+        return std::nullopt;
+
+    return std::stod(arrival_time) + std::stod(deadline) - now::seconds();
+}
+
+
+} // namespace okec
@@ -80,7 +80,7 @@ awaitable::awaitable(std::coroutine_handle<promise_type> handle) noexcept
 {
 }
 
-response_awaiter::response_awaiter(simulator& sim, std::string client_address)
+response_awaiter::response_awaiter(simulator& sim, device_address client_address)
     : sim{ sim },
       client_address{ client_address }
 {
@@ -0,0 +1,304 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/checkpoint.h>
+#include <okec/common/device_address.h>
+#include <okec/common/resource.h>
+#include <okec/common/scenario.h>
+#include <okec/common/simulator.h>
+#include <okec/common/task_id.h>
+#include <okec/devices/edge_device.h>
+#include <okec/utils/log.h>
+#include <okec/utils/profiler.h>
+#include <ns3/rng-seed-manager.h>
+#include <torch/torch.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
+
+namespace okec
+{
+
+namespace {
+
+constexpr int checkpoint_version = 1;
+
+auto key_of(ns3::Ipv4Address ip, std::uint16_t port) -> std::uint64_t
+{
+    return device_address{ ip, port }.key();
+}
+
+auto address_of(std::uint64_t key) -> device_address
+{
+    return { static_cast<std::uint32_t>(key >> 16), static_cast<std::uint16_t>(key & 0xffff) };
+}
+
+auto save_resource(json& items, std::uint64_t key, ns3::Ptr<resource> res) -> void
+{
+    if (res)
+        items.push_back({ { "address", key }, { "data", res->j_data() } });
+}
+
+} // namespace
+
+
+checkpoint::checkpoint(std::shared_ptr<decision_engine> engine, base_station_container& base_stations)
+    : engine_{ std::move(engine) }
+    , base_stations_{ base_stations }
+{
+}
+
+checkpoint::checkpoint(std::shared_ptr<decision_engine> engine, scenario& s)
+    : checkpoint(std::move(engine), s.base_stations())
+{
+    for (auto& clients : s.clients())
+        add_clients(clients);
+
+    if (auto cloud = s.cloud())
+        add_cloud(*cloud);
+}
+
+auto checkpoint::add_clients(client_device_container& clients) -> void
+{
+    clients_.push_back(&clients);
+}
+
+auto checkpoint::add_cloud(cloud_server& cloud) -> void
+{
+    cloud_ = &cloud;
+}
+
+auto checkpoint::save(const std::string& file, checkpoint_options opts) const -> bool
+{
+    if (auto count = in_flight(); count > 0) {
+        log::error("Cannot checkpoint at {:.3f}s: {} dispatched tasks await their response", now::seconds(), count);
+        return false;
+    }
+
+    json state;
+    state["version"] = checkpoint_version;
+    state["time"] = now::time().GetNanoSeconds();
+
+    auto last = task_id::last();
+    state["rng"]["task_id"] = { last.run, last.sequence };
+    state["rng"]["ns3"] = { ns3::RngSeedManager::GetSeed(), ns3::RngSeedManager::GetRun() };
+    {
+        auto generator = at::detail::getDefaultCPUGenerator();
+        std::lock_guard lock{ generator.mutex() };
+        auto bytes = generator.get_state();
+        auto first = bytes.data_ptr<std::uint8_t>();
+        state["rng"]["torch"] = json::binary(std::vector<std::uint8_t>(first, first + bytes.numel()));
+    }
+
+    state["cache"] = json(engine_->cache().data());
+
+    auto& base_stations = state["base_stations"] = json::array();
+    auto& resources = state["resources"] = json::array();
+    for (auto it = base_stations_.cbegin(); it != base_stations_.cend(); ++it) {
+        const auto& bs = *it;
+        json queue = json::array();
+        for (const auto& item : bs->m_task_sequence)
+            queue.push_back(item.j_data());
+
+        base_stations.push_back({
+            { "address", key_of(bs->get_address(), bs->get_port()) },
+            { "queue", std::move(queue) },
+            { "status", bs->m_task_sequence_status }
+        });
+
+        if (bs->m_edge_devices) {
+            for (auto& es : *bs->m_edge_devices)
+                save_resource(resources, key_of(es->get_address(), es->get_port()), es->get_resource());
+        }
+    }
+
+    auto& clients = state["clients"] = json::array();
+    for (auto* container : clients_) {
+        for (auto& client : *container) {
+            auto key = key_of(client->get_address(), client->get_port());
+            save_resource(resources, key, client->get_resource());
+            clients.push_back({ { "address", key }, { "responses", json(client->response_cache().data()) } });
+        }
+    }
+
+    if (cloud_)
+        save_resource(resources, key_of(cloud_->get_address(), cloud_->get_port()), cloud_->get_resource());
+
+    if (opts.engine_state) {
+        json engine_state = json::object();
+        engine_->save_state(engine_state);
+        state["engine"] = std::move(engine_state);
+    }
+
+    std::ofstream out(file, std::ios::binary);
+    if (!out.is_open()) {
+        log::error("Failed to write the checkpoint to {}", file);
+        return false;
+    }
+
+    json::to_msgpack(state, out);
+    return out.good();
+}
+
+auto checkpoint::save_at(ns3::Time time, std::string file, checkpoint_options opts) -> void
+{
+    auto delay = time - now::time();
+    if (delay.IsStrictlyNegative()) {
+        log::warning("Checkpoint time {:.3f}s has passed; saving now.", time.GetSeconds());
+        delay = ns3::Time{};
+    }
+
+    okec::schedule(delay, [this, file = std::move(file), opts] {
+        this->save_when_idle(std::move(file), opts);
+    });
+}
+
+auto checkpoint::save_when_idle(std::string file, checkpoint_options opts) -> void
+{
+    // 等待已分发的任务全部返回后再保存
+    if (in_flight() > 0) {
+        okec::schedule(ns3::MilliSeconds(10), [this, file = std::move(file), opts] {
+            this->save_when_idle(std::move(file), opts);
+        });
+        return;
+    }
+
+    if (save(file, opts))
+        log::info("Checkpoint saved to {} at {:.3f}s", file, now::seconds());
+}
+
+auto checkpoint::restore(const std::string& file) -> bool
+{
+    if (!ns3::Simulator::Now().IsZero()) {
+        log::error("A checkpoint can only be restored before the simulation runs");
+        return false;
+    }
+
+    std::ifstream in(file, std::ios::binary);
+    if (!in.is_open())
+        return false;
+
+    auto state = json::from_msgpack(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>(), true, false);
+    if (state.is_discarded() || state.value("version", 0) != checkpoint_version) {
+        log::error("{} is not a checkpoint of this version", file);
+        return false;
+    }
+
+    now::offset() = ns3::NanoSeconds(state["time"].get<std::int64_t>());
+
+    const auto& rng = state["rng"];
+    task_id::resume_after({ rng["task_id"][0].get<std::uint64_t>(), rng["task_id"][1].get<std::uint64_t>() });
+    ns3::RngSeedManager::SetSeed(rng["ns3"][0].get<std::uint32_t>());
+    ns3::RngSeedManager::SetRun(rng["ns3"][1].get<std::uint64_t>());
+    {
+        const auto& bytes = rng["torch"].get_binary();
+        auto generator = at::detail::getDefaultCPUGenerator();
+        std::lock_guard lock{ generator.mutex() };
+        auto saved = torch::empty({ static_cast<std::int64_t>(bytes.size()) }, torch::kUInt8);
+        std::copy(bytes.begin(), bytes.end(), saved.data_ptr<std::uint8_t>());
+        generator.set_state(saved);
+    }
+
+    auto& cache = engine_->cache();
+    cache.view() = arena_json(state["cache"]);
+    cache.touch_all();
+
+    for (auto& saved : state["base_stations"]) {
+        auto address = saved["address"].get<std::uint64_t>();
+        auto it = std::find_if(base_stations_.begin(), base_stations_.end(), [address](const auto& bs) {
+            return key_of(bs->get_address(), bs->get_port()) == address;
+        });
+        if (it == base_stations_.end()) {
+            log::warning("Checkpoint base station {} not found", address_of(address));
+            continue;
+        }
+
+        auto& bs = *it;
+        bs->m_task_sequence.clear();
+        for (auto& item : saved["queue"])
+            bs->m_task_sequence.emplace_back(std::move(item));
+        bs->m_task_sequence_status = saved["status"].get<std::vector<char>>();
+
+        // 恢复后继续分发尚未分发的任务
+        auto pending = std::ranges::any_of(bs->m_task_sequence, [](const task_element& item) {
+            return item.get_header("status") == "0";
+        });
+        if (pending)
+            okec::schedule(ns3::Time{}, [bs] { bs->handle_next(); });
+    }
+
+    restore_resources(state["resources"]);
+
+    for (auto& saved : state["clients"]) {
+        auto address = saved["address"].get<std::uint64_t>();
+        for (auto* container : clients_) {
+            for (auto& client : *container) {
+                if (key_of(client->get_address(), client->get_port()) == address)
+                    client->response_cache().view() = arena_json(saved["responses"]);
+            }
+        }
+    }
+
+    if (state.contains("engine"))
+        engine_->restore_state(state["engine"]);
+
+    log::info("Checkpoint {} restored at {:.3f}s", file, now::seconds());
+    return true;
+}
+
+auto checkpoint::in_flight() const -> std::size_t
+{
+    std::size_t count{};
+    for (auto it = base_stations_.cbegin(); it != base_stations_.cend(); ++it) {
+        count += std::ranges::count_if((*it)->m_task_sequence, [](const task_element& item) {
+            return item.get_header("status") == "1";
+        });
+    }
+
+    return count;
+}
+
+auto checkpoint::restore_resources(const json& items) const -> void
+{
+    std::unordered_map<std::uint64_t, ns3::Ptr<resource>> resources;
+    auto add = [&resources](ns3::Ipv4Address ip, std::uint16_t port, ns3::Ptr<resource> res) {
+        if (res)
+            resources.emplace(key_of(ip, port), res);
+    };
+
+    for (auto it = base_stations_.cbegin(); it != base_stations_.cend(); ++it) {
+        if ((*it)->m_edge_devices) {
+            for (auto& es : *(*it)->m_edge_devices)
+                add(es->get_address(), es->get_port(), es->get_resource());
+        }
+    }
+    for (auto* container : clients_) {
+        for (auto& client : *container)
+            add(client->get_address(), client->get_port(), client->get_resource());
+    }
+    if (cloud_)
+        add(cloud_->get_address(), cloud_->get_port(), cloud_->get_resource());
+
+    for (const auto& item : items) {
+        auto address = item["address"].get<std::uint64_t>();
+        auto it = resources.find(address);
+        if (it == resources.end()) {
+            log::warning("No resource installed on {} to restore", address_of(address));
+            continue;
+        }
+        it->second->set_data(item["data"]);
+    }
+}
+
+
+} // namespace okec
@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/device_address.h>
+#include <charconv>
+
+
+namespace okec
+{
+
+auto device_address::parse(std::string_view ip, std::string_view port) noexcept -> device_address
+{
+    std::uint32_t value{};
+    auto it = ip.data(), end = ip.data() + ip.size();
+    for (int octet = 0; octet < 4; ++octet) {
+        if (octet > 0) {
+            if (it == end || *it != '.')
+                return {};
+            ++it;
+        }
+
+        std::uint8_t part{};
+        auto [next, ec] = std::from_chars(it, end, part);
+        if (ec != std::errc{} || next - it > 3)
+            return {};
+        value = value << 8 | part;
+        it = next;
+    }
+    if (it != end)
+        return {};
+
+    std::uint16_t number{};
+    if (!port.empty()) {
+        auto [next, ec] = std::from_chars(port.data(), port.data() + port.size(), number);
+        if (ec != std::errc{} || next != port.data() + port.size())
+            return {};
+    }
+
+    return { value, number };
+}
+
+auto device_address::ip_to_chars(char* out) const noexcept -> char*
+{
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        auto octet = (ip >> shift) & 0xff;
+        if (octet >= 100)
+            *out++ = static_cast<char>('0' + octet / 100);
+        if (octet >= 10)
+            *out++ = static_cast<char>('0' + octet / 10 % 10);
+        *out++ = static_cast<char>('0' + octet % 10);
+        if (shift)
+            *out++ = '.';
+    }
+    return out;
+}
+
+auto device_address::ip_string() const -> std::string
+{
+    char buffer[max_ip_chars];
+    return { buffer, ip_to_chars(buffer) };
+}
+
+
+} // namespace okec
@@ -0,0 +1,225 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/execution_model.h>
+#include <okec/common/simulator.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ns3/simulator.h>
+
+
+namespace okec
+{
+
+// Remaining work below this is treated as done, absorbing rounding in advance().
+static constexpr double remaining_epsilon = 1e-9;
+
+// The ns-3 clock ticks in nanoseconds. Departures are scheduled on the next
+// tick, and a job due within one tick is done.
+static constexpr double clock_resolution = 1e-9;
+
+
+execution_model::execution_model(double capacity, std::size_t cores)
+    : capacity_{ capacity },
+      cores_{ std::max<std::size_t>(cores, 1) }
+{
+}
+
+execution_model::~execution_model()
+{
+    if (pending_.IsRunning())
+        pending_.Cancel();
+}
+
+auto execution_model::submit(std::string id, double work, completion_type done, int priority) -> void
+{
+    submit(std::move(id), work, start_type{}, std::move(done), priority);
+}
+
+auto execution_model::submit(std::string id, double work, start_type start, completion_type done, int priority) -> void
+{
+    advance();
+    jobs_.push_back(job {
+        .id = std::move(id),
+        .work = work,
+        .remaining = work,
+        .rate = .0,
+        .arrival_time = now::seconds(),
+        .priority = priority,
+        .started = false,
+        .start = std::move(start),
+        .done = std::move(done)
+    });
+    reschedule();
+}
+
+auto execution_model::capacity() const -> double
+{
+    return capacity_;
+}
+
+auto execution_model::cores() const -> std::size_t
+{
+    return cores_;
+}
+
+auto execution_model::size() const -> std::size_t
+{
+    return jobs_.size();
+}
+
+auto execution_model::completed() const -> std::size_t
+{
+    return completed_;
+}
+
+auto execution_model::core_speed() const -> double
+{
+    return capacity_ / cores_;
+}
+
+auto execution_model::advance() -> void
+{
+    double current = now::seconds();
+    double elapsed = current - last_update_;
+    last_update_ = current;
+    if (elapsed <= .0)
+        return;
+
+    for (auto& item : jobs_) {
+        if (item.rate > .0)
+            item.remaining = std::max(.0, item.remaining - item.rate * elapsed);
+    }
+}
+
+auto execution_model::reschedule() -> void
+{
+    allocate(jobs_);
+
+    double next = std::numeric_limits<double>::infinity();
+    std::vector<start_type> starting;
+    for (auto& item : jobs_) {
+        if (item.rate > .0) {
+            if (!item.started && item.start)
+                starting.push_back(std::move(item.start));
+            item.started = true;
+            next = std::min(next, item.remaining / item.rate);
+        }
+    }
+
+    if (pending_.IsRunning())
+        pending_.Cancel();
+
+    for (auto& start : starting)
+        start();
+
+    if (next == std::numeric_limits<double>::infinity())
+        return;
+
+    auto self = shared_from_this();
+    auto ticks = static_cast<std::uint64_t>(std::ceil(next / clock_resolution));
+    pending_ = okec::schedule(ns3::NanoSeconds(ticks), [self]() {
+        self->on_departure();
+    });
+}
+
+auto execution_model::on_departure() -> void
+{
+    advance();
+
+    // Detach finished jobs first so completion handlers see a consistent model
+    // and may submit new work.
+    std::vector<job> finished;
+    auto first = std::stable_partition(jobs_.begin(), jobs_.end(), [](const job& item) {
+        return !(item.rate > .0 && (item.remaining <= remaining_epsilon * std::max(1.0, item.work)
+            || item.remaining / item.rate < clock_resolution));
+    });
+    std::move(first, jobs_.end(), std::back_inserter(finished));
+    jobs_.erase(first, jobs_.end());
+    completed_ += finished.size();
+
+    reschedule();
+
+    double current = now::seconds();
+    for (auto& item : finished) {
+        if (item.done)
+            item.done(current - item.arrival_time);
+    }
+}
+
+
+auto fcfs_model::name() const -> std::string_view
+{
+    return "fcfs";
+}
+
+auto fcfs_model::allocate(std::vector<job>& jobs) -> void
+{
+    std::size_t free = cores();
+    for (auto& item : jobs) {
+        item.rate = free ? core_speed() : .0;
+        if (free)
+            --free;
+    }
+}
+
+
+auto processor_sharing_model::name() const -> std::string_view
+{
+    return "processor_sharing";
+}
+
+auto processor_sharing_model::allocate(std::vector<job>& jobs) -> void
+{
+    if (jobs.empty())
+        return;
+
+    double share = std::min(core_speed(), capacity() / jobs.size());
+    for (auto& item : jobs)
+        item.rate = share;
+}
+
+
+auto priority_model::name() const -> std::string_view
+{
+    return "priority";
+}
+
+auto priority_model::allocate(std::vector<job>& jobs) -> void
+{
+    // Started jobs keep their core.
+    std::size_t free = cores();
+    for (auto& item : jobs) {
+        item.rate = item.started && free ? core_speed() : .0;
+        if (item.rate > .0)
+            --free;
+    }
+
+    while (free) {
+        auto best = jobs.end();
+        for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+            if (it->rate > .0)
+                continue;
+            if (best == jobs.end() || it->priority > best->priority)
+                best = it;
+        }
+
+        if (best == jobs.end())
+            break;
+
+        best->rate = core_speed();
+        --free;
+    }
+}
+
+
+} // namespace okec
@@ -0,0 +1,228 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/lifecycle.h>
+#include <okec/common/simulator.h>
+#include <okec/utils/format_helper.hpp>
+#include <okec/utils/sys.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+
+namespace okec
+{
+
+namespace {
+
+constexpr double not_reached = std::numeric_limits<double>::quiet_NaN();
+
+constexpr std::array<std::pair<stage, stage>, task_lifecycle::segments> segment_bounds {{
+    { stage::client_send, stage::bs_receive },
+    { stage::bs_receive,  stage::decision },
+    { stage::decision,    stage::es_receive },
+    { stage::es_receive,  stage::start },
+    { stage::start,       stage::finish },
+    { stage::finish,      stage::bs_forward },
+    { stage::bs_forward,  stage::client_receive },
+    { stage::client_send, stage::client_receive }
+}};
+
+// Linear interpolation between closest ranks; `sorted` must not be empty.
+auto percentile(const std::vector<double>& sorted, double p) -> double
+{
+    double rank = std::clamp(p, .0, 100.0) / 100.0 * (sorted.size() - 1);
+    auto lower = static_cast<std::size_t>(rank);
+    auto upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - lower);
+}
+
+} // namespace
+
+
+auto task_lifecycle::instance() -> task_lifecycle&
+{
+    static task_lifecycle lifecycle;
+    return lifecycle;
+}
+
+auto task_lifecycle::enable(bool on) -> void
+{
+    enabled_ = on;
+}
+
+auto task_lifecycle::mark(task_id id, stage s) -> void
+{
+    if (!enabled_)
+        return;
+
+    find_or_create(id).time[static_cast<std::size_t>(s)] = now::seconds();
+}
+
+auto task_lifecycle::mark(std::string_view id, stage s) -> void
+{
+    if (!enabled_)
+        return;
+
+    find_or_create(task_id::parse(id), id).time[static_cast<std::size_t>(s)] = now::seconds();
+}
+
+auto task_lifecycle::set_label(task_id id, label key, std::string_view value) -> void
+{
+    if (!enabled_)
+        return;
+
+    auto label_id = intern(value);
+    find_or_create(id).label[static_cast<std::size_t>(key)] = label_id;
+}
+
+auto task_lifecycle::set_label(std::string_view id, label key, std::string_view value) -> void
+{
+    if (!enabled_)
+        return;
+
+    auto label_id = intern(value);
+    find_or_create(task_id::parse(id), id).label[static_cast<std::size_t>(key)] = label_id;
+}
+
+auto task_lifecycle::size() const -> std::size_t
+{
+    return records_.size();
+}
+
+auto task_lifecycle::duration(const record& r, segment s) const -> double
+{
+    auto [from, to] = segment_bounds[static_cast<std::size_t>(s)];
+    return r.time[static_cast<std::size_t>(to)] - r.time[static_cast<std::size_t>(from)];
+}
+
+auto task_lifecycle::percentiles(segment s, label key, const std::vector<double>& ps) const
+    -> std::map<std::string, std::vector<double>>
+{
+    std::unordered_map<std::uint32_t, std::vector<double>> samples;
+    for (const auto& r : records_) {
+        if (double d = duration(r, s); !std::isnan(d))
+            samples[r.label[static_cast<std::size_t>(key)]].push_back(d);
+    }
+
+    std::map<std::string, std::vector<double>> result;
+    for (auto& [id, values] : samples) {
+        std::ranges::sort(values);
+        auto& out = result[labels_[id]];
+        for (double p : ps)
+            out.push_back(percentile(values, p));
+    }
+
+    return result;
+}
+
+auto task_lifecycle::export_csv(const std::string& file) const -> bool
+{
+    std::ofstream out{ file };
+    if (!out)
+        return false;
+
+    out << "task_id,group,engine,device";
+    for (std::size_t i = 0; i < stages; ++i)
+        out << ',' << stage_name(static_cast<stage>(i));
+    out << '\n';
+
+    for (std::size_t row = 0; row < records_.size(); ++row) {
+        const auto& r = records_[row];
+        if (auto alias = aliases_.find(ids_[row]); alias != aliases_.end()) {
+            out << alias->second;
+        } else {
+            char id[task_id::digits];
+            out.write(id, ids_[row].to_chars(id) - id);
+        }
+        for (auto id : r.label)
+            out << ',' << labels_[id];
+        for (double t : r.time) {
+            out << ',';
+            if (!std::isnan(t))
+                out << okec::format("{:.9f}", t);
+        }
+        out << '\n';
+    }
+
+    return true;
+}
+
+auto task_lifecycle::print_summary(label key) const -> void
+{
+    okec::print("{0:=^{1}}\n", " Task lifecycle (p50 / p90 / p99, ms) ", okec::get_winsize().col);
+    for (std::size_t i = 0; i < segments; ++i) {
+        auto s = static_cast<segment>(i);
+        for (const auto& [name, values] : percentiles(s, key)) {
+            okec::print("{:<12} {:<24} {:>12.3f} {:>12.3f} {:>12.3f}\n",
+                segment_name(s), name.empty() ? "-" : name, values[0] * 1e3, values[1] * 1e3, values[2] * 1e3);
+        }
+    }
+    okec::print("{0:=^{1}}\n", "", okec::get_winsize().col);
+}
+
+auto task_lifecycle::reset() -> void
+{
+    records_.clear();
+    ids_.clear();
+    index_.clear();
+    aliases_.clear();
+    labels_.clear();
+    label_index_.clear();
+}
+
+auto task_lifecycle::segment_name(segment s) -> std::string_view
+{
+    constexpr std::array<std::string_view, segments> names {
+        "uplink", "queueing", "dispatch", "server_wait", "compute", "return_path", "downlink", "total"
+    };
+    return names[static_cast<std::size_t>(s)];
+}
+
+auto task_lifecycle::stage_name(stage s) -> std::string_view
+{
+    constexpr std::array<std::string_view, stages> names {
+        "client_send", "bs_receive", "decision", "es_receive", "start", "finish", "bs_forward", "client_receive"
+    };
+    return names[static_cast<std::size_t>(s)];
+}
+
+auto task_lifecycle::find_or_create(task_id id, std::string_view text) -> record&
+{
+    if (auto it = index_.find(id); it != index_.end())
+        return records_[it->second];
+
+    auto empty_label = intern("");
+    index_.emplace(id, static_cast<std::uint32_t>(records_.size()));
+    ids_.push_back(id);
+    if (id.hashed() && !text.empty())
+        aliases_.emplace(id, text);
+
+    record r;
+    r.time.fill(not_reached);
+    r.label.fill(empty_label);
+    return records_.emplace_back(r);
+}
+
+auto task_lifecycle::intern(std::string_view value) -> std::uint32_t
+{
+    std::string key{ value };
+    if (auto it = label_index_.find(key); it != label_index_.end())
+        return it->second;
+
+    auto id = static_cast<std::uint32_t>(labels_.size());
+    labels_.push_back(key);
+    label_index_.emplace(std::move(key), id);
+    return id;
+}
+
+
+} // namespace okec
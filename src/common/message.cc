@@ -9,19 +9,22 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <okec/common/message.h>
+#include <okec/utils/memory_arena.h>
 
 namespace okec
 {
 
 message::message(ns3::Ptr<ns3::Packet> packet)
 {
-    auto j = packet_helper::to_json(packet);
+    memory_scope scope{ memory_subsystem::message };
+    auto j = packet_helper::to_json<arena_json>(packet);
     if (!j.is_null())
         j_ = std::move(j);
 }
 
 message::message(std::initializer_list<std::pair<std::string_view, std::string_view>> values)
 {
+    memory_scope scope{ memory_subsystem::message };
     for (auto [key, value] : values) {
         j_[key] = value;
     }
@@ -40,6 +43,7 @@ message& message::operator=(message other) noexcept
 
 auto message::attribute(std::string_view key, std::string_view value) -> void
 {
+    memory_scope scope{ memory_subsystem::message };
     j_[key] = value;
 }
 
@@ -90,16 +94,22 @@ auto message::from_packet(ns3::Ptr<ns3::Packet> packet) -> message
 }
 
 auto message::content(const task& t) -> void {
-    j_["content"] = t.j_data();
+    memory_scope scope{ memory_subsystem::message };
+    j_["content"] = t.m_task;
 }
 
 auto message::content(const task_element& item) -> void
 {
-    j_["content"] = item.j_data();
+    memory_scope scope{ memory_subsystem::message };
+    if (item.elem_)
+        j_["content"] = *item.elem_;
+    else
+        j_["content"] = nullptr;
 }
 
 auto message::content(const resource& r) -> void
 {
+    memory_scope scope{ memory_subsystem::message };
     j_["content"] = r.j_data();
 }
 
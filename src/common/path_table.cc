@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/path_table.h>
+#include <cmath>
+#include <limits>
+
+
+namespace okec
+{
+
+namespace {
+
+constexpr double unknown = std::numeric_limits<double>::quiet_NaN();
+
+auto euclidean(const ns3::Vector& a, const ns3::Vector& b) -> double
+{
+    double delta_x = a.x - b.x;
+    double delta_y = a.y - b.y;
+    double delta_z = a.z - b.z;
+
+    return std::sqrt(delta_x * delta_x + delta_y * delta_y + delta_z * delta_z);
+}
+
+} // namespace
+
+path_table::path_table(double propagation_speed)
+    : speed_{ propagation_speed }
+{
+}
+
+auto path_table::resize(std::size_t n) -> void
+{
+    positions_.assign(n, ns3::Vector{});
+    distances_.assign(n, euclidean(origin_, ns3::Vector{}));
+    pairwise_.clear();
+}
+
+auto path_table::size() const -> std::size_t
+{
+    return positions_.size();
+}
+
+auto path_table::set_origin(const ns3::Vector& origin) -> void
+{
+    origin_ = origin;
+    for (std::size_t i = 0; i < positions_.size(); ++i)
+        distances_[i] = euclidean(origin_, positions_[i]);
+}
+
+auto path_table::origin() const -> const ns3::Vector&
+{
+    return origin_;
+}
+
+auto path_table::set_position(std::size_t row, const ns3::Vector& position) -> void
+{
+    positions_[row] = position;
+    distances_[row] = euclidean(origin_, position);
+
+    if (pairwise_.empty())
+        return;
+
+    const auto n = positions_.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        pairwise_[row * n + i] = unknown;
+        pairwise_[i * n + row] = unknown;
+    }
+}
+
+auto path_table::position(std::size_t row) const -> const ns3::Vector&
+{
+    return positions_[row];
+}
+
+auto path_table::set_propagation_speed(double speed) -> void
+{
+    speed_ = speed;
+}
+
+auto path_table::distance(std::size_t row) const -> double
+{
+    return distances_[row];
+}
+
+auto path_table::propagation_delay(std::size_t row) const -> double
+{
+    return distances_[row] / speed_;
+}
+
+auto path_table::distance(std::size_t from, std::size_t to) const -> double
+{
+    const auto n = positions_.size();
+    if (pairwise_.empty())
+        pairwise_.assign(n * n, unknown);
+
+    auto& value = pairwise_[from * n + to];
+    if (std::isnan(value)) {
+        value = euclidean(positions_[from], positions_[to]);
+        pairwise_[to * n + from] = value;
+    }
+
+    return value;
+}
+
+auto path_table::propagation_delay(std::size_t from, std::size_t to) const -> double
+{
+    return distance(from, to) / speed_;
+}
+
+auto path_table::transmission_delay(std::size_t row, double size, double bandwidth) const -> double
+{
+    return size / bandwidth + propagation_delay(row) * 2;
+}
+
+auto path_table::distance_to_origin(const ns3::Vector& position) const -> double
+{
+    return euclidean(origin_, position);
+}
+
+
+} // namespace okec
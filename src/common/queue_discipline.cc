@@ -0,0 +1,252 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/queue_discipline.h>
+#include <okec/common/simulator.h>
+#include <algorithm>
+#include <limits>
+
+
+namespace okec
+{
+
+namespace {
+
+auto header_as_double(const task_element& item, const std::string& key, double fallback) -> double
+{
+    auto value = item.get_header(key);
+    if (value.empty())
+        return fallback;
+
+    try {
+        return std::stod(value);
+    } catch (...) {
+        return fallback;
+    }
+}
+
+// Picks the pending task with the smallest key, ties broken by queue order.
+template <typename KeyFn>
+auto min_pending(queue_discipline::sequence_type& sequence, KeyFn key, auto is_pending)
+{
+    auto best = sequence.end();
+    double best_key = std::numeric_limits<double>::infinity();
+    for (auto it = sequence.begin(); it != sequence.end(); ++it) {
+        if (!is_pending(*it))
+            continue;
+
+        double k = key(*it);
+        if (best == sequence.end() || k < best_key) {
+            best = it;
+            best_key = k;
+        }
+    }
+
+    return best;
+}
+
+} // namespace
+
+
+auto queue_metrics::on_dispatch(double wait_time, double cpu_demand) -> void
+{
+    advance();
+    ++dispatched_;
+    total_wait_ += wait_time;
+    max_wait_ = std::max(max_wait_, wait_time);
+    in_flight_ += cpu_demand;
+}
+
+auto queue_metrics::on_release(double cpu_demand) -> void
+{
+    advance();
+    in_flight_ = std::max(.0, in_flight_ - cpu_demand);
+}
+
+auto queue_metrics::set_capacity(double capacity) -> void
+{
+    capacity_ = capacity;
+}
+
+auto queue_metrics::capacity() const -> double
+{
+    return capacity_;
+}
+
+auto queue_metrics::dispatched() const -> std::size_t
+{
+    return dispatched_;
+}
+
+auto queue_metrics::average_wait_time() const -> double
+{
+    return dispatched_ ? total_wait_ / dispatched_ : .0;
+}
+
+auto queue_metrics::max_wait_time() const -> double
+{
+    return max_wait_;
+}
+
+auto queue_metrics::utilization() const -> double
+{
+    double current = now::seconds();
+    if (capacity_ <= .0 || start_time_ < .0 || current <= start_time_)
+        return .0;
+
+    double area = busy_area_ + in_flight_ * (current - last_time_);
+    return area / (capacity_ * (current - start_time_));
+}
+
+auto queue_metrics::advance() -> void
+{
+    double current = now::seconds();
+    if (start_time_ < .0) {
+        start_time_ = current;
+        last_time_ = current;
+        return;
+    }
+
+    busy_area_ += in_flight_ * (current - last_time_);
+    last_time_ = current;
+}
+
+
+auto queue_discipline::on_remove(const task_element&) -> void
+{
+}
+
+auto queue_discipline::metrics() -> queue_metrics&
+{
+    return metrics_;
+}
+
+auto queue_discipline::is_pending(const task_element& item) -> bool
+{
+    return item.get_header("status") == "0";
+}
+
+
+auto fifo_discipline::name() const -> std::string_view
+{
+    return "fifo";
+}
+
+auto fifo_discipline::clone() const -> std::shared_ptr<queue_discipline>
+{
+    return std::make_shared<fifo_discipline>();
+}
+
+auto fifo_discipline::select(sequence_type& sequence, const decide_type& decide) -> result_type
+{
+    auto it = std::ranges::find_if(sequence, is_pending);
+    if (it == sequence.end())
+        return { it, decision_type{} };
+
+    return { it, decide(*it) };
+}
+
+
+auto edf_discipline::name() const -> std::string_view
+{
+    return "edf";
+}
+
+auto edf_discipline::clone() const -> std::shared_ptr<queue_discipline>
+{
+    return std::make_shared<edf_discipline>();
+}
+
+auto edf_discipline::select(sequence_type& sequence, const decide_type& decide) -> result_type
+{
+    auto it = min_pending(sequence, [](const task_element& item) {
+        double arrival = header_as_double(item, "arrival_time", .0);
+        return arrival + header_as_double(item, "deadline", std::numeric_limits<double>::infinity());
+    }, is_pending);
+    if (it == sequence.end())
+        return { it, decision_type{} };
+
+    return { it, decide(*it) };
+}
+
+
+auto sdf_discipline::name() const -> std::string_view
+{
+    return "sdf";
+}
+
+auto sdf_discipline::clone() const -> std::shared_ptr<queue_discipline>
+{
+    return std::make_shared<sdf_discipline>();
+}
+
+auto sdf_discipline::select(sequence_type& sequence, const decide_type& decide) -> result_type
+{
+    auto it = min_pending(sequence, [](const task_element& item) {
+        return header_as_double(item, "cpu", .0);
+    }, is_pending);
+    if (it == sequence.end())
+        return { it, decision_type{} };
+
+    return { it, decide(*it) };
+}
+
+
+backfill_discipline::backfill_discipline(std::size_t starvation_bound)
+    : starvation_bound_{ starvation_bound }
+{
+}
+
+auto backfill_discipline::name() const -> std::string_view
+{
+    return "backfill";
+}
+
+auto backfill_discipline::clone() const -> std::shared_ptr<queue_discipline>
+{
+    return std::make_shared<backfill_discipline>(starvation_bound_);
+}
+
+auto backfill_discipline::select(sequence_type& sequence, const decide_type& decide) -> result_type
+{
+    auto head = std::ranges::find_if(sequence, is_pending);
+    if (head == sequence.end())
+        return { head, decision_type{} };
+
+    auto head_id = head->id();
+    if (auto decision = decide(*head); !decision.is_null()) {
+        bypassed_.erase(head_id);
+        return { head, std::move(decision) };
+    }
+
+    // The head has waited long enough; stop letting others overtake it.
+    if (bypassed_[head_id] >= starvation_bound_)
+        return { head, decision_type{} };
+
+    for (auto it = std::next(head); it != sequence.end(); ++it) {
+        if (!is_pending(*it))
+            continue;
+
+        if (auto decision = decide(*it); !decision.is_null()) {
+            ++bypassed_[head_id];
+            return { it, std::move(decision) };
+        }
+    }
+
+    return { head, decision_type{} };
+}
+
+auto backfill_discipline::on_remove(const task_element& item) -> void
+{
+    bypassed_.erase(item.id());
+}
+
+
+} // namespace okec
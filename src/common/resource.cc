@@ -10,6 +10,9 @@
 
 #include <okec/common/resource.h>
 #include <okec/utils/format_helper.hpp>
+#include <algorithm>
+#include <charconv>
+#include <deque>
 #include <fstream>
 #include <random>
 
@@ -21,6 +24,31 @@ if (index > size()) throw std::out_of_range{"index out of range"}
 namespace okec
 {
 
+namespace {
+
+auto attribute_names() -> std::deque<std::string>&
+{
+    static std::deque<std::string> names;
+    return names;
+}
+
+auto parse_number(std::string_view text, double& value) -> bool
+{
+    auto first = text.data(), last = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    return ec == std::errc{} && ptr == last && first != last;
+}
+
+auto format_number(double value, resource::attribute_type type) -> std::string
+{
+    if (type == resource::attribute_type::integer)
+        return okec::format("{}", static_cast<long long>(value));
+
+    return okec::format("{}", value);
+}
+
+} // namespace
+
 NS_OBJECT_ENSURE_REGISTERED(resource);
 
 
@@ -42,31 +70,101 @@ resource::resource(json item) noexcept
 {
     if (item.contains("/resource"_json_pointer)) {
         j_ = std::move(item);
+        load_numbers();
     }
 }
 
 auto resource::attribute(std::string_view key, std::string_view value) -> void
 {
+    double number_value{};
+    if (parse_number(value, number_value)) {
+        set_number(key, number_value, attribute_type::real, {});
+        j_["resource"][key] = value; // 保留原始文本
+        return;
+    }
+
+    std::erase_if(numbers_, [key](const number& n) { return name_of(n.id) == key; });
     j_["resource"][key] = value;
 }
 
 auto resource::reset_value(std::string_view key, std::string_view value) -> std::string
 {
+    double number_value{};
+    if (auto n = find_number(key); n && parse_number(value, number_value)) {
+        auto type = n->type;
+        return format_number(this->set(key, number_value), type);
+    }
+
+    std::erase_if(numbers_, [key](const number& n) { return name_of(n.id) == key; });
+    sync();
     auto old_value = std::exchange(j_["resource"][key], value);
-    if (monitor_) {
-        monitor_(okec::format("{:ip}", get_address()), key, old_value.get<std::string>(), value);
+    auto old_text = old_value.is_string() ? old_value.get<std::string>() : std::string{};
+    if (monitor_ || tracer_) {
+        auto address = okec::format("{:ip}", get_address());
+        if (monitor_)
+            monitor_(address, key, old_text, value);
+        if (tracer_)
+            tracer_->record(address, key, value);
     }
     
+    return old_text;
+}
+
+auto resource::set(std::string_view key, double value) -> double
+{
+    auto n = find_number(key);
+    if (!n) {
+        set_number(key, value, attribute_type::real, {});
+        return 0.0;
+    }
+
+    auto old_value = std::exchange(n->value, value);
+    n->dirty = true;
+    dirty_ = true;
+    changed(*n, old_value);
     return old_value;
 }
 
+auto resource::add(std::string_view key, double delta) -> double
+{
+    auto n = find_number(key);
+    if (!n) {
+        set_number(key, delta, attribute_type::real, {});
+        return delta;
+    }
+
+    auto old_value = n->value;
+    n->value += delta;
+    n->dirty = true;
+    dirty_ = true;
+    changed(*n, old_value);
+    return n->value;
+}
+
+auto resource::unit(std::string_view key) const -> std::string_view
+{
+    auto n = find_number(key);
+    return n ? std::string_view{ n->unit } : std::string_view{};
+}
+
 auto resource::set_monitor(monitor_type monitor) -> void
 {
     monitor_ = monitor;
 }
 
+auto resource::set_change_monitor(change_monitor_type monitor) -> void
+{
+    change_monitor_ = std::move(monitor);
+}
+
+auto resource::set_tracer(std::shared_ptr<resource_tracer> tracer) -> void
+{
+    tracer_ = std::move(tracer);
+}
+
 auto resource::get_value(std::string_view key) const -> std::string
 {
+    sync();
     std::string result{};
     json::json_pointer j_key{ "/resource/" + std::string(key) };
     if (j_.contains(j_key))
@@ -75,6 +173,101 @@ auto resource::get_value(std::string_view key) const -> std::string
     return result;
 }
 
+auto resource::id_of(std::string_view key) -> attribute_id
+{
+    auto& names = attribute_names();
+    auto it = std::find(names.begin(), names.end(), key);
+    if (it != names.end())
+        return static_cast<attribute_id>(it - names.begin());
+
+    names.emplace_back(key);
+    return static_cast<attribute_id>(names.size() - 1);
+}
+
+auto resource::name_of(attribute_id id) -> const std::string&
+{
+    return attribute_names().at(id);
+}
+
+auto resource::find_number(std::string_view key) const -> const number*
+{
+    for (const auto& n : numbers_) {
+        if (name_of(n.id) == key)
+            return &n;
+    }
+
+    return nullptr;
+}
+
+auto resource::find_number(std::string_view key) -> number*
+{
+    return const_cast<number*>(std::as_const(*this).find_number(key));
+}
+
+auto resource::set_number(std::string_view key, double value, attribute_type type, std::string_view unit) -> void
+{
+    if (auto n = find_number(key)) {
+        n->type = type;
+        n->value = value;
+        n->unit = unit;
+        n->dirty = false;
+    } else {
+        numbers_.push_back(number{ id_of(key), type, value, std::string(unit), false });
+    }
+
+    // 定义属性不是热路径，直接写回 json
+    j_["resource"][key] = format_number(value, type);
+}
+
+auto resource::changed(const number& n, double old_value) -> void
+{
+    if (change_monitor_) {
+        change_monitor_(change_event{ node_ ? node_->GetId() : 0u, n.id, old_value, n.value });
+    }
+
+    if (monitor_ || tracer_) {
+        auto address = okec::format("{:ip}", get_address());
+        if (monitor_)
+            monitor_(address, name_of(n.id), format_number(old_value, n.type), format_number(n.value, n.type));
+        if (tracer_)
+            tracer_->record(address, name_of(n.id), n.value);
+    }
+}
+
+auto resource::load_numbers() -> void
+{
+    numbers_.clear();
+    dirty_ = false;
+    if (empty())
+        return;
+
+    for (auto& [key, value] : j_["resource"].items()) {
+        double number_value{};
+        if (value.is_string() && parse_number(value.get<std::string>(), number_value)) {
+            numbers_.push_back(number{ id_of(key), attribute_type::real, number_value, {}, false });
+        } else if (value.is_number()) {
+            // 数值一律以字符串形式对外，与原有的 TO_STR/TO_DOUBLE 用法保持一致
+            auto type = value.is_number_integer() ? attribute_type::integer : attribute_type::real;
+            numbers_.push_back(number{ id_of(key), type, value.get<double>(), {}, true });
+            dirty_ = true;
+        }
+    }
+}
+
+auto resource::sync() const -> void
+{
+    if (!dirty_)
+        return;
+
+    for (auto& n : numbers_) {
+        if (n.dirty) {
+            j_["resource"][name_of(n.id)] = format_number(n.value, n.type);
+            n.dirty = false;
+        }
+    }
+    dirty_ = false;
+}
+
 auto resource::get_address() -> ns3::Ipv4Address
 {
     auto ipv4 = node_->GetObject<ns3::Ipv4>();
@@ -83,6 +276,7 @@ auto resource::get_address() -> ns3::Ipv4Address
 
 auto resource::dump(const int indent) -> std::string
 {
+    sync();
     return j_.dump(indent);
 }
 
@@ -93,6 +287,7 @@ auto resource::empty() const -> bool
 
 auto resource::j_data() const -> json
 {
+    sync();
     return j_;
 }
 
@@ -100,6 +295,7 @@ auto resource::set_data(json item) -> bool
 {
     if (item.contains("/resource"_json_pointer)) {
         j_ = std::move(item);
+        load_numbers();
         return true;
     }
 
@@ -176,37 +372,24 @@ auto resource_container::print(std::string title) -> void
 
 auto resource_container::trace_resource() -> void
 {
-    namespace fs = std::filesystem;
-    static std::ofstream file;
-    fs::path p{"data/"};
-    if (!fs::exists(p)) {
-        fs::create_directory(p);
-    }
-    
-    p.append("resource_tracer.csv");
+    if (m_tracer)
+        return;
 
-    if (!file.is_open()) {
-        file.open(p, std::ios::out/* | std::ios::app*/);
-        if (!file.is_open()) {
-            return;
-        }
-    }
+    enable_tracing()->convert_on_close("data/resource_tracer.csv");
+}
 
-    // for (const auto& item : m_resources) {
-    //     file << okec::format("At time {:.2f}s,{:ip}", Simulator::Now().GetSeconds(), item->get_address());
-    //     for (auto it = item->begin(); it != item->end(); ++it) {
-    //         file << okec::format(",{}: {}", it.key(), it.value());
-    //     }
-    //     file << "\n";
-    // }
-    // file << "\n";
-    file << okec::format("{:.2f}", ns3::Simulator::Now().GetSeconds());
+auto resource_container::enable_tracing(std::string file, bool background) -> std::shared_ptr<resource_tracer>
+{
+    m_tracer = std::make_shared<resource_tracer>(std::move(file), 1 << 20, background);
     for (const auto& item : m_resources) {
+        auto address = okec::format("{:ip}", item->get_address());
         for (auto it = item->begin(); it != item->end(); ++it) {
-            file << okec::format(",{}", it.value().get<std::string>());
+            m_tracer->record(address, it.key(), it.value().get<std::string>());
         }
+        item->set_tracer(m_tracer);
     }
-    file << "\n";
+
+    return m_tracer;
 }
 
 auto resource_container::save_to_file(const std::string& file) -> void
@@ -251,4 +434,11 @@ auto resource_container::set_monitor(resource::monitor_type monitor) -> void
     }
 }
 
+auto resource_container::set_change_monitor(resource::change_monitor_type monitor) -> void
+{
+    for (const auto& item : m_resources) {
+        item->set_change_monitor(monitor);
+    }
+}
+
 } // namespace okec
\ No newline at end of file
@@ -0,0 +1,205 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/resource_schema.h>
+#include <algorithm>
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+
+
+namespace okec
+{
+
+namespace {
+
+auto to_number(const arena_json& value) -> double
+{
+    if (value.is_number())
+        return value.get<double>();
+
+    double result{};
+    if (value.is_string()) {
+        const auto& text = value.get_ref<const std::string&>();
+        std::from_chars(text.data(), text.data() + text.size(), result);
+    }
+
+    return result;
+}
+
+} // namespace
+
+resource_schema::resource_schema()
+    : names_{ "cpu" }
+{
+}
+
+auto resource_schema::instance() -> resource_schema&
+{
+    static resource_schema schema;
+    return schema;
+}
+
+auto resource_schema::define(std::vector<std::string> dimensions) -> void
+{
+    if (dimensions.empty() || dimensions.size() > max_dimensions)
+        throw std::invalid_argument{ "a resource schema has 1 to 8 dimensions" };
+
+    names_ = std::move(dimensions);
+    ++generation_;
+}
+
+auto resource_schema::dimensions() const -> std::size_t
+{
+    return names_.size();
+}
+
+auto resource_schema::name(std::size_t index) const -> const std::string&
+{
+    return names_.at(index);
+}
+
+auto resource_schema::index_of(std::string_view name) const -> std::optional<std::size_t>
+{
+    auto it = std::ranges::find(names_, name);
+    if (it == names_.end())
+        return std::nullopt;
+
+    return static_cast<std::size_t>(it - names_.begin());
+}
+
+auto resource_schema::generation() const -> std::size_t
+{
+    return generation_;
+}
+
+auto resource_schema::demand(const task_element& item) const -> vector_type
+{
+    vector_type result{};
+    for (std::size_t d = 0; d < names_.size(); ++d) {
+        auto text = item.get_header(names_[d]);
+        std::from_chars(text.data(), text.data() + text.size(), result[d]);
+    }
+
+    return result;
+}
+
+auto resource_schema::supply(const arena_json& item) const -> vector_type
+{
+    vector_type result{};
+    for (std::size_t d = 0; d < names_.size(); ++d) {
+        if (auto it = item.find(names_[d]); it != item.end())
+            result[d] = to_number(*it);
+    }
+
+    return result;
+}
+
+
+auto resource_matrix::resize(std::size_t rows, std::size_t dimensions) -> void
+{
+    rows_ = rows;
+    dimensions_ = std::min(dimensions, resource_schema::max_dimensions);
+    for (std::size_t d = 0; d < dimensions_; ++d)
+        columns_[d].assign(rows_, 0.0);
+    enabled_.assign(rows_, 1.0);
+}
+
+auto resource_matrix::rows() const -> std::size_t
+{
+    return rows_;
+}
+
+auto resource_matrix::dimensions() const -> std::size_t
+{
+    return dimensions_;
+}
+
+auto resource_matrix::set_row(std::size_t row, const vector_type& supply) -> void
+{
+    for (std::size_t d = 0; d < dimensions_; ++d)
+        columns_[d][row] = supply[d];
+}
+
+auto resource_matrix::set(std::size_t row, std::size_t dimension, double value) -> void
+{
+    columns_[dimension][row] = value;
+}
+
+auto resource_matrix::get(std::size_t row, std::size_t dimension) const -> double
+{
+    return columns_[dimension][row];
+}
+
+auto resource_matrix::set_enabled(std::size_t row, bool enabled) -> void
+{
+    enabled_[row] = enabled ? 1.0 : 0.0;
+}
+
+auto resource_matrix::place(const vector_type& demand, placement_policy policy) const -> std::optional<std::size_t>
+{
+    constexpr double lowest = -std::numeric_limits<double>::infinity();
+    const std::size_t n = rows_;
+    if (n == 0)
+        return std::nullopt;
+
+    score_.assign(n, policy == placement_policy::dominant ? std::numeric_limits<double>::infinity() : 0.0);
+    feasible_.assign(enabled_.begin(), enabled_.end());
+    double* score = score_.data();
+    double* feasible = feasible_.data();
+
+    // One pass per dimension; the loop bodies have no branches.
+    for (std::size_t d = 0; d < dimensions_; ++d) {
+        const double* column = columns_[d].data();
+        const double need = demand[d];
+
+        double scale = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+            scale = std::max(scale, column[i]);
+        const double inverse = scale > 0.0 ? 1.0 / scale : 0.0;
+
+        switch (policy) {
+        case placement_policy::worst_fit:
+            for (std::size_t i = 0; i < n; ++i) {
+                double left = column[i] - need;
+                feasible[i] *= static_cast<double>(left >= 0.0);
+                score[i] += left * inverse;
+            }
+            break;
+        case placement_policy::best_fit:
+            for (std::size_t i = 0; i < n; ++i) {
+                double left = column[i] - need;
+                feasible[i] *= static_cast<double>(left >= 0.0);
+                score[i] -= left * inverse;
+            }
+            break;
+        case placement_policy::dominant:
+            for (std::size_t i = 0; i < n; ++i) {
+                double left = column[i] - need;
+                feasible[i] *= static_cast<double>(left >= 0.0);
+                score[i] = std::min(score[i], left * inverse);
+            }
+            break;
+        }
+    }
+
+    for (std::size_t i = 0; i < n; ++i)
+        score[i] = feasible[i] != 0.0 ? score[i] : lowest;
+
+    // The first best row, so ties go to the earlier server as before.
+    auto best = std::max_element(score, score + n);
+    if (*best == lowest)
+        return std::nullopt;
+
+    return static_cast<std::size_t>(best - score);
+}
+
+
+} // namespace okec
@@ -0,0 +1,419 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/resource_tracer.h>
+#include <okec/common/simulator.h>
+#include <okec/utils/format_helper.hpp>
+#include <okec/utils/log.h>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <map>
+
+
+namespace okec
+{
+
+namespace {
+
+constexpr char magic[] = { 'O', 'K', 'R', 'T' };
+constexpr char version = 1;
+
+class reader
+{
+public:
+    explicit reader(const std::string& file)
+        : in_{ file, std::ios::binary }
+    {
+    }
+
+    auto header_ok() -> bool {
+        char head[sizeof(magic) + 1]{};
+        return in_.read(head, sizeof(head)) && std::memcmp(head, magic, sizeof(magic)) == 0 && head[sizeof(magic)] == version;
+    }
+
+    template <typename T>
+    auto get(T& value) -> bool {
+        return static_cast<bool>(in_.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    auto get_string(std::string& s) -> bool {
+        std::uint16_t length{};
+        if (!get(length))
+            return false;
+        s.resize(length);
+        return static_cast<bool>(in_.read(s.data(), length));
+    }
+
+private:
+    std::ifstream in_;
+};
+
+struct delta
+{
+    double time;
+    std::uint32_t node;
+    std::uint16_t attribute;
+    double value;
+};
+
+struct trace_content
+{
+    std::vector<std::string> nodes;
+    std::vector<std::string> attributes;
+    std::vector<delta> deltas;
+    std::vector<std::pair<std::size_t, std::string>> markers; // [before delta index, text]
+};
+
+auto load(const std::string& file, trace_content& content) -> bool
+{
+    reader r{ file };
+    if (!r.header_ok()) {
+        log::error("{} is not a resource trace", file);
+        return false;
+    }
+
+    auto assign = [](std::vector<std::string>& names, std::size_t id, std::string name) {
+        if (names.size() <= id)
+            names.resize(id + 1);
+        names[id] = std::move(name);
+    };
+
+    char tag{};
+    while (r.get(tag)) {
+        switch (tag) {
+        case 'N': {
+            std::uint32_t id{};
+            std::string name;
+            if (!r.get(id) || !r.get_string(name)) return false;
+            assign(content.nodes, id, std::move(name));
+            break;
+        }
+        case 'A': {
+            std::uint16_t id{};
+            std::string name;
+            if (!r.get(id) || !r.get_string(name)) return false;
+            assign(content.attributes, id, std::move(name));
+            break;
+        }
+        case 'D': {
+            delta d{};
+            if (!r.get(d.time) || !r.get(d.node) || !r.get(d.attribute) || !r.get(d.value)) return false;
+            content.deltas.push_back(d);
+            break;
+        }
+        case 'M': {
+            double time{};
+            std::string text;
+            if (!r.get(time) || !r.get_string(text)) return false;
+            content.markers.emplace_back(content.deltas.size(), std::move(text));
+            break;
+        }
+        default:
+            log::error("corrupted resource trace {} (tag {})", file, static_cast<int>(tag));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+
+resource_tracer::resource_tracer(std::string file, std::size_t block_size, bool background)
+    : file_{ std::move(file) },
+      block_size_{ std::max<std::size_t>(block_size, 4096) },
+      background_{ background }
+{
+    if (auto parent = std::filesystem::path{ file_ }.parent_path(); !parent.empty())
+        std::filesystem::create_directories(parent);
+
+    out_.open(file_, std::ios::binary | std::ios::trunc);
+    if (!out_)
+        log::error("Failed to open resource trace {}", file_);
+
+    block_.reserve(block_size_ + 256);
+    block_.insert(block_.end(), std::begin(magic), std::end(magic));
+    block_.push_back(version);
+
+    if (background_)
+        writer_ = std::thread{ &resource_tracer::writer_loop, this };
+}
+
+resource_tracer::~resource_tracer()
+{
+    close();
+}
+
+template <typename T>
+auto resource_tracer::put(const T& value) -> void
+{
+    auto bytes = reinterpret_cast<const char*>(&value);
+    block_.insert(block_.end(), bytes, bytes + sizeof(T));
+}
+
+auto resource_tracer::put_bytes(std::string_view bytes) -> void
+{
+    auto length = static_cast<std::uint16_t>(std::min<std::size_t>(bytes.size(), std::numeric_limits<std::uint16_t>::max()));
+    put(length);
+    block_.insert(block_.end(), bytes.begin(), bytes.begin() + length);
+}
+
+auto resource_tracer::node_id(std::string_view node) -> std::uint32_t
+{
+    if (auto it = nodes_.find(node); it != nodes_.end())
+        return it->second;
+
+    auto id = static_cast<std::uint32_t>(nodes_.size());
+    nodes_.emplace(node, id);
+    block_.push_back('N');
+    put(id);
+    put_bytes(node);
+    return id;
+}
+
+auto resource_tracer::attribute_id(std::string_view attribute) -> std::uint16_t
+{
+    if (auto it = attributes_.find(attribute); it != attributes_.end())
+        return it->second;
+
+    auto id = static_cast<std::uint16_t>(attributes_.size());
+    attributes_.emplace(attribute, id);
+    block_.push_back('A');
+    put(id);
+    put_bytes(attribute);
+    return id;
+}
+
+auto resource_tracer::record(std::string_view node, std::string_view attribute, double value) -> void
+{
+    if (closed_)
+        return;
+
+    auto n = node_id(node);
+    auto a = attribute_id(attribute);
+    block_.push_back('D');
+    put(now::seconds());
+    put(n);
+    put(a);
+    put(value);
+    ++records_;
+
+    if (block_.size() >= block_size_)
+        submit_block();
+}
+
+auto resource_tracer::record(std::string_view node, std::string_view attribute, std::string_view value) -> void
+{
+    double number = std::numeric_limits<double>::quiet_NaN();
+    std::from_chars(value.data(), value.data() + value.size(), number);
+    record(node, attribute, number);
+}
+
+auto resource_tracer::mark(std::string_view text) -> void
+{
+    if (closed_)
+        return;
+
+    block_.push_back('M');
+    put(now::seconds());
+    put_bytes(text);
+}
+
+auto resource_tracer::flush() -> void
+{
+    if (closed_)
+        return;
+
+    submit_block();
+    if (!background_)
+        out_.flush();
+}
+
+auto resource_tracer::submit_block() -> void
+{
+    if (block_.empty())
+        return;
+
+    if (!background_) {
+        out_.write(block_.data(), block_.size());
+        block_.clear();
+        return;
+    }
+
+    std::vector<char> full;
+    full.reserve(block_size_ + 256);
+    full.swap(block_);
+    {
+        std::lock_guard lock{ mutex_ };
+        pending_.push_back(std::move(full));
+    }
+    ready_.notify_one();
+}
+
+auto resource_tracer::writer_loop() -> void
+{
+    std::unique_lock lock{ mutex_ };
+    for (;;) {
+        ready_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+        while (!pending_.empty()) {
+            auto block = std::move(pending_.front());
+            pending_.pop_front();
+            lock.unlock();
+            out_.write(block.data(), block.size());
+            lock.lock();
+        }
+
+        if (stopping_)
+            break;
+    }
+    out_.flush();
+}
+
+auto resource_tracer::close() -> void
+{
+    if (closed_)
+        return;
+
+    submit_block();
+    closed_ = true;
+
+    if (background_ && writer_.joinable()) {
+        {
+            std::lock_guard lock{ mutex_ };
+            stopping_ = true;
+        }
+        ready_.notify_one();
+        writer_.join();
+    }
+    out_.close();
+
+    if (!convert_file_.empty())
+        to_csv(file_, convert_file_, convert_layout_);
+}
+
+auto resource_tracer::convert_on_close(std::string csv_file, layout l) -> void
+{
+    convert_file_ = std::move(csv_file);
+    convert_layout_ = l;
+}
+
+auto resource_tracer::file() const -> const std::string&
+{
+    return file_;
+}
+
+auto resource_tracer::records() const -> std::size_t
+{
+    return records_;
+}
+
+auto resource_tracer::to_csv(const std::string& trace_file, const std::string& csv_file, layout l) -> bool
+{
+    trace_content content;
+    if (!load(trace_file, content))
+        return false;
+
+    std::ofstream out{ csv_file };
+    if (!out)
+        return false;
+
+    auto marker = content.markers.begin();
+    auto write_markers = [&](std::size_t index) {
+        for (; marker != content.markers.end() && marker->first <= index; ++marker)
+            out << "# " << marker->second << '\n';
+    };
+
+    if (l == layout::tall) {
+        out << "time,node,attribute,value\n";
+        for (std::size_t i = 0; i < content.deltas.size(); ++i) {
+            write_markers(i);
+            const auto& d = content.deltas[i];
+            out << okec::format("{:.9f},{},{},{}\n", d.time, content.nodes[d.node], content.attributes[d.attribute], d.value);
+        }
+        write_markers(content.deltas.size());
+        return true;
+    }
+
+    // Wide: columns in order of first appearance, one row per distinct instant.
+    std::map<std::pair<std::uint32_t, std::uint16_t>, std::size_t> columns;
+    std::vector<std::pair<std::uint32_t, std::uint16_t>> order;
+    for (const auto& d : content.deltas) {
+        if (columns.emplace(std::pair{ d.node, d.attribute }, order.size()).second)
+            order.emplace_back(d.node, d.attribute);
+    }
+
+    out << "time";
+    for (auto [node, attribute] : order)
+        out << ',' << content.nodes[node] << '/' << content.attributes[attribute];
+    out << '\n';
+
+    std::vector<double> row(order.size(), std::numeric_limits<double>::quiet_NaN());
+    auto write_row = [&](double time) {
+        out << okec::format("{:.9f}", time);
+        for (double v : row) {
+            out << ',';
+            if (v == v)
+                out << v;
+        }
+        out << '\n';
+    };
+
+    for (std::size_t i = 0; i < content.deltas.size(); ++i) {
+        write_markers(i);
+        const auto& d = content.deltas[i];
+        row[columns[{ d.node, d.attribute }]] = d.value;
+        bool last_of_instant = i + 1 == content.deltas.size() || content.deltas[i + 1].time != d.time;
+        if (last_of_instant)
+            write_row(d.time);
+    }
+    write_markers(content.deltas.size());
+
+    return true;
+}
+
+auto resource_tracer::to_columns(const std::string& trace_file, const std::string& directory) -> bool
+{
+    trace_content content;
+    if (!load(trace_file, content))
+        return false;
+
+    std::filesystem::path dir{ directory };
+    std::filesystem::create_directories(dir);
+
+    auto write_column = [&](const char* name, auto member) {
+        std::ofstream out{ dir / name, std::ios::binary };
+        for (const auto& d : content.deltas) {
+            auto value = d.*member;
+            out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+        return static_cast<bool>(out);
+    };
+
+    bool ok = write_column("time.f64", &delta::time)
+           && write_column("node.u32", &delta::node)
+           && write_column("attribute.u16", &delta::attribute)
+           && write_column("value.f64", &delta::value);
+
+    std::ofstream names{ dir / "names.csv" };
+    names << "kind,id,name\n";
+    for (std::size_t i = 0; i < content.nodes.size(); ++i)
+        names << "node," << i << ',' << content.nodes[i] << '\n';
+    for (std::size_t i = 0; i < content.attributes.size(); ++i)
+        names << "attribute," << i << ',' << content.attributes[i] << '\n';
+
+    return ok && static_cast<bool>(names);
+}
+
+
+} // namespace okec
@@ -10,12 +10,14 @@
 
 #include <okec/common/response.h>
 #include <okec/utils/log.h>
+#include <okec/utils/memory_arena.h>
 
 namespace okec
 {
 
 response::response(const response& other) noexcept
 {
+    memory_scope scope{ memory_subsystem::response };
     if (this != &other) {
         this->j_ = other.j_;
     }
@@ -68,7 +70,8 @@ auto response::size() const -> std::size_t
 
 auto response::emplace_back(attributes_type values) -> void
 {
-    json item;
+    memory_scope scope{ memory_subsystem::response };
+    arena_json item;
     for (auto [key, value] : values) {
         item[key] = value;
     }
@@ -91,6 +94,7 @@ auto response::count_if(unary_predicate_type pred) const -> int
 
 auto response::dump_with(unary_predicate_type pred) -> response
 {
+    memory_scope scope{ memory_subsystem::response };
     response result;
     auto& items = this->view();
     for (auto it = items.begin(); it != items.end();) {
@@ -106,6 +110,7 @@ auto response::dump_with(unary_predicate_type pred) -> response
 
 auto response::dump_with(attributes_type values) -> response
 {
+    memory_scope scope{ memory_subsystem::response };
     response res;
     auto& items = j_["response"]["items"];
     for (std::size_t i = 0; i < items.size(); ++i)
@@ -142,8 +147,9 @@ auto response::dump_with(attribute_type value) -> response
     return dump_with({value});
 }
 
-auto response::emplace_back(json item) -> void
+auto response::emplace_back(arena_json item) -> void
 {
+    memory_scope scope{ memory_subsystem::response };
     j_["response"]["items"].emplace_back(std::move(item));
 }
 
@@ -0,0 +1,464 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/scenario.h>
+#include <okec/common/simulator.h>
+#include <okec/network/cloud_edge_end_model.hpp>
+#include <okec/network/multiple_LAN_WLAN_network_model.hpp>
+#include <okec/network/multiple_and_single_LAN_WLAN_network_model.hpp>
+#include <okec/utils/log.h>
+#include <okec/utils/random.hpp>
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+
+namespace okec
+{
+
+namespace {
+
+// The built-in models give every LAN and WLAN a /24 network.
+constexpr std::size_t max_segment_hosts = 253;
+
+class problems
+{
+public:
+    auto add(std::string_view path, std::string_view what) -> void {
+        text_ += okec::format("\n  {}: {}", path, what);
+        ++count_;
+    }
+
+    auto check() const -> void {
+        if (count_)
+            throw std::invalid_argument{ okec::format("invalid scenario ({} problems):{}", count_, text_) };
+    }
+
+private:
+    std::string text_;
+    std::size_t count_{};
+};
+
+auto unknown_keys(const json& object, std::initializer_list<std::string_view> known,
+    std::string_view path, problems& errors) -> void
+{
+    for (const auto& [key, _] : object.items()) {
+        if (std::ranges::find(known, key) == known.end())
+            errors.add(okec::format("{}.{}", path, key), "unknown key");
+    }
+}
+
+auto to_number(const json& value, double& result) -> bool
+{
+    if (value.is_number()) {
+        result = value.get<double>();
+        return true;
+    }
+
+    if (value.is_string()) {
+        const auto& text = value.get_ref<const std::string&>();
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), result);
+        return ec == std::errc{} && ptr == text.data() + text.size();
+    }
+
+    return false;
+}
+
+auto to_count(const json& object, std::string_view key, std::size_t fallback,
+    std::string_view path, problems& errors) -> std::size_t
+{
+    auto it = object.find(key);
+    if (it == object.end())
+        return fallback;
+
+    if (!it->is_number_unsigned()) {
+        errors.add(okec::format("{}.{}", path, key), "expected a non-negative integer");
+        return fallback;
+    }
+
+    return it->get<std::size_t>();
+}
+
+// Units ns3::DataRate and ns3::Time accept after the number.
+constexpr std::string_view rate_units[] = {
+    "bps", "b/s", "Bps", "B/s",
+    "kbps", "kb/s", "Kbps", "Kb/s", "kBps", "kB/s", "KBps", "KB/s", "Kib/s", "KiB/s",
+    "Mbps", "Mb/s", "MBps", "MB/s", "Mib/s", "MiB/s",
+    "Gbps", "Gb/s", "GBps", "GB/s", "Gib/s", "GiB/s"
+};
+
+constexpr std::string_view time_units[] = {
+    "y", "d", "h", "min", "s", "ms", "us", "ns", "ps", "fs"
+};
+
+// "5Mbps", "2ms", "6560ns": a number followed by one of `units`.
+template <std::size_t N>
+auto is_quantity(const std::string& text, const std::string_view (&units)[N]) -> bool
+{
+    double value{};
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || value < 0)
+        return false;
+
+    std::string_view unit(ptr, text.data() + text.size() - ptr);
+    return std::ranges::find(units, unit) != std::end(units);
+}
+
+auto parse_link(const json& object, link_config& link, std::string_view path, problems& errors) -> void
+{
+    if (!object.is_object()) {
+        errors.add(path, "expected an object");
+        return;
+    }
+
+    unknown_keys(object, { "data_rate", "delay" }, path, errors);
+    if (auto it = object.find("data_rate"); it != object.end()) {
+        if (!it->is_string() || !is_quantity(it->get<std::string>(), rate_units))
+            errors.add(okec::format("{}.data_rate", path), "expected a data rate with an ns-3 unit, e.g. \"5Mbps\" or \"100kb/s\"");
+        else
+            link.data_rate = it->get<std::string>();
+    }
+
+    if (auto it = object.find("delay"); it != object.end()) {
+        if (!it->is_string() || !is_quantity(it->get<std::string>(), time_units))
+            errors.add(okec::format("{}.delay", path), "expected a time with an ns-3 unit, e.g. \"2ms\" or \"6560ns\"");
+        else
+            link.delay = it->get<std::string>();
+    }
+}
+
+} // namespace
+
+
+scenario::scenario(simulator& sim, const json& description)
+    : scenario(sim, parse(description))
+{
+}
+
+scenario::scenario(simulator& sim, plan&& p)
+    : plan_{ std::move(p) }
+    , base_stations_(sim, plan_.cells.size())
+{
+    // Base stations keep pointers to their edge servers.
+    edge_servers_.reserve(plan_.cells.size());
+    clients_.reserve(plan_.cells.size());
+    for (std::size_t i = 0; i < plan_.cells.size(); ++i) {
+        edge_servers_.emplace_back(sim, plan_.cells[i].edge_servers);
+        clients_.emplace_back(sim, plan_.cells[i].clients);
+        base_stations_[i]->connect_device(edge_servers_[i]);
+    }
+
+    if (plan_.has_cloud)
+        cloud_ = std::make_unique<cloud_server>(sim);
+
+    build_network();
+    install_resources();
+
+    if (plan_.stop_time > 0)
+        sim.stop_time(ns3::Seconds(plan_.stop_time));
+}
+
+auto scenario::load(simulator& sim, const std::string& file) -> std::unique_ptr<scenario>
+{
+    std::ifstream fin(file);
+    if (!fin.is_open())
+        throw std::invalid_argument{ okec::format("{} does not exist", file) };
+
+    auto description = json::parse(fin, nullptr, false, true);
+    if (description.is_discarded())
+        throw std::invalid_argument{ okec::format("{} is not valid JSON", file) };
+
+    return std::unique_ptr<scenario>(new scenario(sim, description));
+}
+
+auto scenario::base_stations() -> base_station_container&
+{
+    return base_stations_;
+}
+
+auto scenario::edge_servers() -> std::vector<edge_device_container>&
+{
+    return edge_servers_;
+}
+
+auto scenario::clients() -> std::vector<client_device_container>&
+{
+    return clients_;
+}
+
+auto scenario::cloud() -> cloud_server*
+{
+    return cloud_.get();
+}
+
+auto scenario::launch() -> void
+{
+    if (!plan_.tasks_per_client)
+        return;
+
+    std::size_t index{};
+    for (auto& group : clients_) {
+        for (std::size_t i = 0; i < group.size(); ++i, ++index) {
+            json items = json::array();
+            for (std::size_t n = 0; n < plan_.tasks_per_client; ++n) {
+                json header{
+                    { "task_id", task::unique_id() },
+                    { "group", okec::format("client-{}", index) }
+                };
+                for (const auto& [key, range] : plan_.task_attributes)
+                    header[key] = draw(range);
+                items.push_back({ { "header", std::move(header) } });
+            }
+
+            task t(json{ { "task", { { "items", std::move(items) } } } });
+            group.get_device(i)->send(std::move(t));
+        }
+    }
+}
+
+auto scenario::parse(const json& description) -> plan
+{
+    problems errors;
+    plan result;
+
+    auto parse_attributes = [&errors](const json& object, std::string_view path, attributes& out) {
+        if (!object.is_object()) {
+            errors.add(path, "expected an object");
+            return;
+        }
+
+        for (const auto& [key, value] : object.items()) {
+            auto where = okec::format("{}.{}", path, key);
+            value_range range{};
+            if (to_number(value, range.low)) {
+                range.high = range.low;
+            } else if (!value.is_array() || value.size() != 2
+                || !to_number(value[0], range.low) || !to_number(value[1], range.high)) {
+                errors.add(where, "expected a number or a [low, high] range");
+                continue;
+            } else if (range.low > range.high) {
+                errors.add(where, "low is greater than high");
+                continue;
+            }
+            out.emplace_back(key, range);
+        }
+    };
+
+    if (!description.is_object()) {
+        errors.add("scenario", "expected an object");
+        errors.check();
+    }
+
+    unknown_keys(description, { "network", "base_stations", "cloud", "workload", "stop_time" }, "scenario", errors);
+
+    // Cloud tier
+    result.has_cloud = description.contains("cloud");
+    if (result.has_cloud) {
+        const auto& cloud = description["cloud"];
+        if (!cloud.is_object()) {
+            errors.add("cloud", "expected an object");
+        } else {
+            unknown_keys(cloud, { "resources" }, "cloud", errors);
+            if (cloud.contains("resources"))
+                parse_attributes(cloud["resources"], "cloud.resources", result.cloud_resources);
+        }
+    }
+
+    // Network
+    result.model = result.has_cloud ? "cloud_edge_end" : "multiple_and_single_LAN_WLAN";
+    if (auto it = description.find("network"); it != description.end()) {
+        const auto& network = *it;
+        if (!network.is_object()) {
+            errors.add("network", "expected an object");
+        } else {
+            unknown_keys(network, { "model", "links", "wifi" }, "network", errors);
+
+            if (network.contains("model")) {
+                const auto& model = network["model"];
+                if (model != "cloud_edge_end" && model != "multiple_LAN_WLAN" && model != "multiple_and_single_LAN_WLAN")
+                    errors.add("network.model", "expected cloud_edge_end, multiple_LAN_WLAN or multiple_and_single_LAN_WLAN");
+                else
+                    result.model = model.get<std::string>();
+            }
+
+            if (result.model == "multiple_LAN_WLAN")
+                result.links = multiple_LAN_WLAN_network_model{}.links;
+
+            if (network.contains("links")) {
+                const auto& links = network["links"];
+                if (!links.is_object()) {
+                    errors.add("network.links", "expected an object");
+                } else {
+                    unknown_keys(links, { "edge", "lan", "cloud", "backbone" }, "network.links", errors);
+                    for (auto [key, link] : { std::pair{ "edge", &result.links.edge }, std::pair{ "lan", &result.links.lan },
+                                              std::pair{ "cloud", &result.links.cloud }, std::pair{ "backbone", &result.links.backbone } }) {
+                        if (links.contains(key))
+                            parse_link(links[key], *link, okec::format("network.links.{}", key), errors);
+                    }
+                }
+            }
+
+            if (network.contains("wifi")) {
+                const auto& wifi = network["wifi"];
+                if (!wifi.is_object()) {
+                    errors.add("network.wifi", "expected an object");
+                } else {
+                    unknown_keys(wifi, { "ssid", "bounds" }, "network.wifi", errors);
+                    if (wifi.contains("ssid")) {
+                        if (!wifi["ssid"].is_string() || wifi["ssid"].get_ref<const std::string&>().empty())
+                            errors.add("network.wifi.ssid", "expected a non-empty string");
+                        else
+                            result.links.wifi.ssid = wifi["ssid"].get<std::string>();
+                    }
+                    if (wifi.contains("bounds")) {
+                        if (!wifi["bounds"].is_number() || wifi["bounds"].get<double>() <= 0)
+                            errors.add("network.wifi.bounds", "expected a positive number");
+                        else
+                            result.links.wifi.bounds = wifi["bounds"].get<double>();
+                    }
+                }
+            }
+        }
+    }
+
+    if (result.model == "cloud_edge_end" && !result.has_cloud)
+        errors.add("cloud", "the cloud_edge_end model needs a cloud tier");
+    if (result.model != "cloud_edge_end" && result.has_cloud)
+        errors.add("cloud", okec::format("the {} model does not connect a cloud server", result.model));
+
+    // Base stations, edge servers and clients
+    auto stations = description.find("base_stations");
+    if (stations == description.end() || !stations->is_array() || stations->empty()) {
+        errors.add("base_stations", "expected a non-empty array");
+    } else {
+        for (std::size_t i = 0; i < stations->size(); ++i) {
+            const auto& group = (*stations)[i];
+            auto path = okec::format("base_stations[{}]", i);
+            if (!group.is_object()) {
+                errors.add(path, "expected an object");
+                continue;
+            }
+
+            unknown_keys(group, { "count", "edge_servers", "clients", "resources" }, path, errors);
+
+            cell c{};
+            auto count = to_count(group, "count", 1, path, errors);
+            c.edge_servers = to_count(group, "edge_servers", 1, path, errors);
+            c.clients = to_count(group, "clients", 1, path, errors);
+
+            if (c.edge_servers == 0 || c.edge_servers > max_segment_hosts)
+                errors.add(path + ".edge_servers", okec::format("expected 1 to {} edge servers per base station", max_segment_hosts));
+            if (c.clients + 1 > max_segment_hosts)
+                errors.add(path + ".clients", okec::format("at most {} clients share a base station", max_segment_hosts - 1));
+            if (group.contains("resources"))
+                parse_attributes(group["resources"], path + ".resources", c.resources);
+
+            result.cells.insert(result.cells.end(), count, c);
+        }
+
+        if (result.cells.empty())
+            errors.add("base_stations", "the groups add up to no base station");
+    }
+
+    if (result.model == "multiple_LAN_WLAN" && result.cells.size() == 1)
+        errors.add("network.model", "multiple_LAN_WLAN needs at least 2 base stations");
+
+    // Workload
+    if (auto it = description.find("workload"); it != description.end()) {
+        const auto& workload = *it;
+        if (!workload.is_object()) {
+            errors.add("workload", "expected an object");
+        } else {
+            unknown_keys(workload, { "tasks_per_client", "attributes" }, "workload", errors);
+            result.tasks_per_client = to_count(workload, "tasks_per_client", 0, "workload", errors);
+            if (workload.contains("attributes")) {
+                parse_attributes(workload["attributes"], "workload.attributes", result.task_attributes);
+            } else {
+                result.task_attributes = {
+                    { "cpu", { 0.2, 1.2 } },
+                    { "size", { 0.5, 2.0 } },
+                    { "deadline", { 10, 100 } }
+                };
+            }
+        }
+    }
+
+    if (description.contains("stop_time")) {
+        const auto& stop_time = description["stop_time"];
+        if (!stop_time.is_number() || stop_time.get<double>() <= 0)
+            errors.add("stop_time", "expected a positive number of seconds");
+        else
+            result.stop_time = stop_time.get<double>();
+    }
+
+    errors.check();
+    return result;
+}
+
+auto scenario::draw(const value_range& range) -> std::string
+{
+    if (range.low == range.high)
+        return okec::format("{}", range.low);
+
+    return rand_range(range.low, range.high).to_string();
+}
+
+auto scenario::build_network() -> void
+{
+    auto single = plan_.cells.size() == 1;
+
+    if (plan_.model == "cloud_edge_end") {
+        cloud_edge_end_model model;
+        model.links = plan_.links;
+        if (single)
+            network_initializer(model, clients_[0], base_stations_.get(0), *cloud_);
+        else
+            network_initializer(model, clients_, base_stations_, *cloud_);
+    } else if (plan_.model == "multiple_LAN_WLAN") {
+        multiple_LAN_WLAN_network_model model;
+        model.links = plan_.links;
+        network_initializer(model, clients_, base_stations_);
+    } else {
+        multiple_and_single_LAN_WLAN_network_model model;
+        model.links = plan_.links;
+        if (single)
+            network_initializer(model, clients_[0], base_stations_.get(0));
+        else
+            network_initializer(model, clients_, base_stations_);
+    }
+}
+
+auto scenario::install_resources() -> void
+{
+    for (std::size_t i = 0; i < plan_.cells.size(); ++i) {
+        const auto& specs = plan_.cells[i].resources;
+        if (specs.empty())
+            continue;
+
+        resource_container resources(edge_servers_[i].size());
+        resources.initialize([&specs](auto res) {
+            for (const auto& [key, range] : specs)
+                res->attribute(key, draw(range));
+        });
+        edge_servers_[i].install_resources(resources);
+    }
+
+    if (cloud_ && !plan_.cloud_resources.empty()) {
+        auto res = make_resource();
+        for (const auto& [key, range] : plan_.cloud_resources)
+            res->attribute(key, draw(range));
+        cloud_->install_resource(res);
+    }
+}
+
+
+} // namespace okec
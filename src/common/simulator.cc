@@ -1,7 +1,10 @@
 #include <okec/common/simulator.h>
 #include <okec/common/response.h>
 #include <okec/config/config.h>
+#include <okec/network/link_model.h>
+#include <okec/network/udp_application.h>
 #include <okec/utils/log.h>
+#include <okec/utils/memory_arena.h>
 
 
 
@@ -9,7 +12,8 @@ namespace okec
 {
 
 simulator::simulator(ns3::Time time)
-    : stop_time_{std::move(time)}
+    : arena_{ memory_arena::open() }
+    , stop_time_{std::move(time)}
 {
     // log::debug("C++ version: {}", __cplusplus);
     ns3::Time::SetResolution(ns3::Time::NS);
@@ -17,13 +21,30 @@ simulator::simulator(ns3::Time time)
 
 simulator::~simulator()
 {
+    udp_application::set_link_model(nullptr);
     ns3::Simulator::Destroy();
+    now::offset() = ns3::Time{};
+    arena_->close();
 }
 
 auto simulator::run() -> void
 {
-    ns3::Simulator::Stop(stop_time_);
+    auto remaining = stop_time_ - now::offset();
+    if (!remaining.IsStrictlyPositive()) {
+        log::warning("The stop time {:.3f}s is not after the restored time {:.3f}s.", stop_time_.GetSeconds(), now::offset().GetSeconds());
+        remaining = ns3::Time{};
+    }
+
+    ns3::Simulator::Stop(remaining);
     ns3::Simulator::Run();
+
+    if (profiler::enabled()) {
+        auto& p = profiler::instance();
+        p.print_table();
+        arena_->print_stats();
+        if (!p.write_folded(profile_file_))
+            log::error("Failed to write the profile to {}", profile_file_);
+    }
 }
 
 auto simulator::stop_time(ns3::Time time) -> void
@@ -41,29 +62,62 @@ auto simulator::enable_visualizer() -> void
     ns3::GlobalValue::Bind("SimulatorImplementationType", ns3::StringValue("ns3::VisualSimulatorImpl"));
 }
 
+auto simulator::enable_fast_network(std::shared_ptr<link_model> model) -> void
+{
+    if (!model)
+        model = std::make_shared<bandwidth_link_model>();
+    udp_application::set_link_model(std::move(model));
+}
+
+auto simulator::disable_fast_network() -> void
+{
+    udp_application::set_link_model(nullptr);
+}
+
+auto simulator::enable_profiler(std::string folded_file) -> void
+{
+    profile_file_ = std::move(folded_file);
+    profiler::instance().enable();
+}
+
+auto simulator::memory() const -> const memory_arena&
+{
+    return *arena_;
+}
+
+auto simulator::submit(device_address client, std::function<void(response &&)> fn) -> void
+{
+    completion_[client] = std::move(fn);
+}
+
 auto simulator::submit(const std::string &ip, std::function<void(response &&)> fn) -> void
 {
-    completion_[ip] = fn;
+    this->submit(device_address::parse(ip), std::move(fn));
 }
 
-auto simulator::complete(const std::string& ip, response&& r) -> void
+auto simulator::complete(device_address client, response&& r) -> void
 {
-    if (auto it = completion_.find(ip);
+    if (auto it = completion_.find(client);
         it != completion_.end()) {
-        auto fn = it->second;
+        auto fn = std::move(it->second);
         completion_.erase(it);
         fn(std::move(r));
     }
 }
 
-auto simulator::is_valid(const std::string &ip) -> bool
+auto simulator::complete(const std::string& ip, response&& r) -> void
+{
+    this->complete(device_address::parse(ip), std::move(r));
+}
+
+auto simulator::is_valid(device_address client) const -> bool
 {
-    if (auto it = completion_.find(ip);
-        it != completion_.end()) {
-        return true;
-    }
+    return completion_.contains(client);
+}
 
-    return false;
+auto simulator::is_valid(const std::string &ip) const -> bool
+{
+    return this->is_valid(device_address::parse(ip));
 }
 
 auto simulator::hold_coro(awaitable a) -> void
@@ -10,10 +10,10 @@
 
 #include <okec/common/task.h>
 #include <okec/utils/format_helper.hpp>
+#include <okec/utils/memory_arena.h>
 #include <algorithm>
 #include <fstream>
-#include <random>
-#include <sstream>
+#include <iomanip>
 #include <ns3/ptr.h>
 
 
@@ -21,67 +21,122 @@
 namespace okec
 {
 
-task_element::task_element(json* item) noexcept
+namespace {
+
+auto read_id(const arena_json* item) -> task_id
+{
+    if (!item)
+        return {};
+
+    auto header = item->find("header");
+    if (header == item->end())
+        return {};
+
+    auto value = header->find("task_id");
+    if (value == header->end() || !value->is_string())
+        return {};
+
+    return task_id::parse(value->get_ref<const arena_json::string_t&>());
+}
+
+} // namespace
+
+task_element::task_element(arena_json* item) noexcept
+    : task_element(item, false)
 {
-    if (item->contains("/header"_json_pointer)) {
-        elem_ = item; // ref
-        is_dynamically_allocated = false;
+}
+
+task_element::task_element(const arena_json* item, bool read_only) noexcept
+    : read_only_{ read_only }
+{
+    if (item && item->contains("/header"_json_pointer)) {
+        elem_ = const_cast<arena_json*>(item); // ref
+        id_ = read_id(elem_);
     }
-    else
-        elem_ = nullptr;
 }
 
 task_element::task_element(json item) noexcept
 {
+    memory_scope scope{ memory_subsystem::task };
     if (item.contains("/header"_json_pointer)) {
-        elem_ = new json(std::move(item)); // copy
-        is_dynamically_allocated = true;
+        payload_ = std::allocate_shared<arena_json>(arena_allocator<arena_json>{}, item);
+        elem_ = payload_.get();
+        id_ = read_id(elem_);
     }
-    else
-        elem_ = nullptr;
 }
 
-task_element::task_element(const task_element& other) noexcept
+task_element::task_element(arena_json item) noexcept
 {
-    if (this != &other) {
-        elem_ = new json(*other.elem_); // copy
-        is_dynamically_allocated = true;
+    memory_scope scope{ memory_subsystem::task };
+    if (item.contains("/header"_json_pointer)) {
+        payload_ = std::allocate_shared<arena_json>(arena_allocator<arena_json>{}, std::move(item));
+        elem_ = payload_.get();
+        id_ = read_id(elem_);
     }
 }
 
+task_element::task_element(const task_element& other) noexcept
+{
+    assign(other);
+}
+
 task_element& task_element::operator=(const task_element& other) noexcept
 {
-    if (this != &other) {
-        elem_ = new json(*other.elem_); // copy
-        is_dynamically_allocated = true;
-    }
+    if (this != &other)
+        assign(other);
 
     return *this;
 }
 
 task_element::task_element(task_element&& other) noexcept
     : elem_ { std::exchange(other.elem_, nullptr) }
-    , is_dynamically_allocated { std::exchange(other.is_dynamically_allocated, false) }
+    , payload_ { std::move(other.payload_) }
+    , read_only_ { std::exchange(other.read_only_, false) }
+    , id_ { std::exchange(other.id_, {}) }
 {
 }
 
 task_element& task_element::operator=(task_element&& other) noexcept
 {
     elem_ = std::exchange(other.elem_, nullptr);
-    is_dynamically_allocated = std::exchange(other.is_dynamically_allocated, false);
+    payload_ = std::move(other.payload_);
+    read_only_ = std::exchange(other.read_only_, false);
+    id_ = std::exchange(other.id_, {});
     return *this;
 }
 
-task_element::~task_element()
+auto task_element::assign(const task_element& other) -> void
+{
+    if (other.payload_) {
+        payload_ = other.payload_; // share
+        elem_ = other.elem_;
+    } else if (other.elem_) {
+        memory_scope scope{ memory_subsystem::task };
+        payload_ = std::allocate_shared<arena_json>(arena_allocator<arena_json>{}, *other.elem_); // snapshot of a view
+        elem_ = payload_.get();
+    } else {
+        payload_.reset();
+        elem_ = nullptr;
+    }
+    read_only_ = false;
+    id_ = elem_ ? other.id_ : task_id{};
+}
+
+auto task_element::mutable_data() -> arena_json*
 {
-    if (elem_ != nullptr && is_dynamically_allocated)
-        delete elem_;
+    if (elem_ && (read_only_ || payload_.use_count() > 1)) {
+        payload_ = std::allocate_shared<arena_json>(arena_allocator<arena_json>{}, *elem_); // copy on write
+        elem_ = payload_.get();
+        read_only_ = false;
+    }
+
+    return elem_;
 }
 
 auto task_element::get_header(const std::string& key) const -> std::string
 {
     std::string result{};
-    json::json_pointer j_key{ "/header/" + key };
+    arena_json::json_pointer j_key{ "/header/" + key };
     if (elem_ && elem_->contains(j_key))
         elem_->at(j_key).get_to(result);
     
@@ -90,9 +145,12 @@ auto task_element::get_header(const std::string& key) const -> std::string
 
 auto task_element::set_header(std::string_view key, std::string_view value) -> bool
 {
-    if (elem_) {
-        json::json_pointer j_key{ "/header/" + std::string(key) };
-        (*elem_)[j_key] = value;
+    memory_scope scope{ memory_subsystem::task };
+    if (auto item = mutable_data()) {
+        arena_json::json_pointer j_key{ "/header/" + std::string(key) };
+        (*item)[j_key] = value;
+        if (key == "task_id")
+            id_ = task_id::parse(value);
         return true;
     }
 
@@ -102,7 +160,7 @@ auto task_element::set_header(std::string_view key, std::string_view value) -> b
 auto task_element::get_body(const std::string& key) const -> std::string
 {
     std::string result{};
-    json::json_pointer j_key{ "/body/" + key };
+    arena_json::json_pointer j_key{ "/body/" + key };
     if (elem_ && elem_->contains(j_key))
         elem_->at(j_key).get_to(result);
     
@@ -111,9 +169,10 @@ auto task_element::get_body(const std::string& key) const -> std::string
 
 auto task_element::set_body(std::string_view key, std::string_view value) -> bool
 {
-    if (elem_) {
-        json::json_pointer j_key{ "/body/" + std::string(key) };
-        (*elem_)[j_key] = value;
+    memory_scope scope{ memory_subsystem::task };
+    if (auto item = mutable_data()) {
+        arena_json::json_pointer j_key{ "/body/" + std::string(key) };
+        (*item)[j_key] = value;
         return true;
     }
 
@@ -122,7 +181,12 @@ auto task_element::set_body(std::string_view key, std::string_view value) -> boo
 
 auto task_element::j_data() const -> json
 {
-    return elem_ ? *elem_ : json{};
+    return elem_ ? json(*elem_) : json{};
+}
+
+auto task_element::id() const -> task_id
+{
+    return id_;
 }
 
 auto task_element::empty() const -> bool
@@ -130,11 +194,17 @@ auto task_element::empty() const -> bool
     return elem_;
 }
 
+auto task_element::shared() const -> bool
+{
+    return read_only_ || payload_.use_count() > 1;
+}
+
 auto task_element::from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> task_element
 {
-    json j = packet_helper::to_json(packet);
+    memory_scope scope{ memory_subsystem::task };
+    auto j = packet_helper::to_json<arena_json>(packet);
     if (!j.is_null() && j.contains("/content/header"_json_pointer))
-        return task_element(j["content"]);
+        return task_element(std::move(j["content"]));
     
     return task_element{nullptr};
 }
@@ -142,35 +212,46 @@ auto task_element::from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> task_element
 auto task_element::dump(int indent) const -> std::string
 {
     std::string result{};
-    if (!elem_->is_null())
+    if (elem_ && !elem_->is_null())
         result = elem_->dump(indent);
     return result;
 }
 
 task::task(json other)
 {
+    memory_scope scope{ memory_subsystem::task };
+    if (other.contains("/task/items"_json_pointer))
+        m_task = std::move(other);
+}
+
+task::task(arena_json other)
+{
+    memory_scope scope{ memory_subsystem::task };
     if (other.contains("/task/items"_json_pointer))
         m_task = std::move(other);
 }
 
 auto task::from_packet(ns3::Ptr<ns3::Packet> packet) -> task
 {
-    json j = packet_helper::to_json(packet);
-    return j.is_null() ? task{} : task(j);
+    memory_scope scope{ memory_subsystem::task };
+    auto j = packet_helper::to_json<arena_json>(packet);
+    return j.is_null() ? task{} : task(std::move(j));
 }
 
 auto task::from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> task
 {
-    json j = packet_helper::to_json(packet);
+    memory_scope scope{ memory_subsystem::task };
+    auto j = packet_helper::to_json<arena_json>(packet);
     if (!j.is_null() && j.contains("/content/task"_json_pointer))
-        return task(j["content"]);
+        return task(std::move(j["content"]));
     
     return task{};
 }
 
 auto task::emplace_back(task_header header_attrs, task_body body_attrs) -> void
 {
-    json item;
+    memory_scope scope{ memory_subsystem::task };
+    arena_json item;
     // Set header attributes
     for (auto [key, value] : header_attrs) {
         item["header"][key] = value;
@@ -193,7 +274,7 @@ auto task::elements_view() -> std::vector<task_element>
 {
     std::vector<task_element> items;
     items.reserve(this->size());
-    for (json& item : m_task["task"]["items"])
+    for (arena_json& item : m_task["task"]["items"])
         items.emplace_back(task_element(&item));
 
     return items;
@@ -204,12 +285,38 @@ auto task::elements() const -> std::vector<task_element>
     std::vector<task_element> items;
     items.reserve(this->size());
 
-    for (const json& item : m_task["task"]["items"])
+    for (const arena_json& item : m_task["task"]["items"])
         items.emplace_back(task_element(item));
 
     return items;
 }
 
+auto task::element_views() const -> std::vector<task_element>
+{
+    std::vector<task_element> items;
+    items.reserve(this->size());
+
+    for (const arena_json& item : m_task["task"]["items"])
+        items.push_back(task_element(&item, true));
+
+    return items;
+}
+
+auto task::release_elements() -> std::vector<task_element>
+{
+    memory_scope scope{ memory_subsystem::task };
+    std::vector<task_element> items;
+    items.reserve(this->size());
+
+    if (m_task.contains("/task/items"_json_pointer)) {
+        for (arena_json& item : m_task["task"]["items"])
+            items.emplace_back(std::move(item));
+        m_task = arena_json{};
+    }
+
+    return items;
+}
+
 auto task::at(std::size_t index) noexcept -> task_element
 {
     return task_element(&m_task["task"]["items"].at(index));
@@ -320,35 +427,7 @@ auto task::get_body(const json& element, const std::string& key) -> std::string
 
 auto task::unique_id() -> std::string
 {
-    static std::random_device              rd;
-    static std::mt19937                    gen(rd());
-    static std::uniform_int_distribution<> dis(0, 15);
-    static std::uniform_int_distribution<> dis2(8, 11);
-
-    std::stringstream ss;
-    int i;
-    ss << std::hex << std::uppercase;
-    for (i = 0; i < 8; i++) {
-        ss << dis(gen);
-    }
-    // ss << "-";
-    for (i = 0; i < 4; i++) {
-        ss << dis(gen);
-    }
-    // ss << "-4";
-    for (i = 0; i < 3; i++) {
-        ss << dis(gen);
-    }
-    // ss << "-";
-    ss << dis2(gen);
-    for (i = 0; i < 3; i++) {
-        ss << dis(gen);
-    }
-    // ss << "-";
-    for (i = 0; i < 12; i++) {
-        ss << dis(gen);
-    };
-    return ss.str();
+    return task_id::next().to_string();
 }
 
 auto task::save_to_file(const std::string& file_name) -> void
@@ -359,11 +438,12 @@ auto task::save_to_file(const std::string& file_name) -> void
 
 auto task::load_from_file(const std::string& file_name) -> bool
 {
+    memory_scope scope{ memory_subsystem::task };
     std::ifstream fin(file_name);
     if (!fin.is_open())
         return false;
 
-    json data;
+    arena_json data;
     fin >> data;
 
     if (!data.contains("/task/items"_json_pointer))
@@ -383,7 +463,7 @@ auto task::operator[](std::size_t index) const noexcept -> task_element
     return this->at(index);
 }
 
-auto task::push_back(const json &sub) -> void
+auto task::push_back(const arena_json &sub) -> void
 {
     m_task.push_back(sub);
 }
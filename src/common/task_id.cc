@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/task_id.h>
+#include <atomic>
+#include <random>
+
+
+namespace okec
+{
+
+namespace {
+
+auto draw_run() -> std::uint64_t
+{
+    std::random_device rd;
+    std::uint64_t run = (std::uint64_t{ rd() } << 32) | rd();
+    return run == ~std::uint64_t{} ? run - 1 : run; // reserved for hashed ids
+}
+
+auto hex_value(char c) noexcept -> int
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+struct generator {
+    std::atomic<std::uint64_t> run{ draw_run() };
+    std::atomic<std::uint64_t> sequence{ 0 };
+};
+
+auto id_generator() -> generator&
+{
+    static generator g;
+    return g;
+}
+
+} // namespace
+
+
+auto task_id::next() noexcept -> task_id
+{
+    auto& g = id_generator();
+    return { g.run.load(std::memory_order_relaxed), g.sequence.fetch_add(1, std::memory_order_relaxed) + 1 };
+}
+
+auto task_id::last() noexcept -> task_id
+{
+    auto& g = id_generator();
+    return { g.run.load(std::memory_order_relaxed), g.sequence.load(std::memory_order_relaxed) };
+}
+
+auto task_id::resume_after(task_id last) noexcept -> void
+{
+    auto& g = id_generator();
+    g.run.store(last.run, std::memory_order_relaxed);
+    g.sequence.store(last.sequence, std::memory_order_relaxed);
+}
+
+auto task_id::parse(std::string_view text) noexcept -> task_id
+{
+    // Only the form to_chars() writes counts as hex, so that every id has
+    // exactly one spelling; "1", "01" and "0...0a" are hashed as text.
+    task_id id{};
+    bool hex = text.size() == digits;
+    for (auto c : text) {
+        auto value = hex_value(c);
+        if (value < 0) {
+            hex = false;
+            break;
+        }
+        id.run = (id.run << 4) | (id.sequence >> 60);
+        id.sequence = (id.sequence << 4) | static_cast<std::uint64_t>(value);
+    }
+
+    if (hex)
+        return id;
+
+    // FNV-1a
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    for (auto c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001B3ull;
+    }
+    return { ~std::uint64_t{}, hash };
+}
+
+auto task_id::to_chars(char* out) const noexcept -> char*
+{
+    constexpr char hex[] = "0123456789ABCDEF";
+    for (int shift = 60; shift >= 0; shift -= 4)
+        *out++ = hex[(run >> shift) & 0xf];
+    for (int shift = 60; shift >= 0; shift -= 4)
+        *out++ = hex[(sequence >> shift) & 0xf];
+    return out;
+}
+
+auto task_id::to_string() const -> std::string
+{
+    std::string result(digits, '0');
+    to_chars(result.data());
+    return result;
+}
+
+
+} // namespace okec
@@ -29,7 +29,8 @@ base_station::base_station(simulator& sim)
     : sim_{ sim },
       m_edge_devices{ nullptr },
       m_udp_application{ ns3::CreateObject<udp_application>() },
-      m_node{ ns3::CreateObject<ns3::Node>() }
+      m_node{ ns3::CreateObject<ns3::Node>() },
+      m_queue_discipline{ std::make_shared<fifo_discipline>() }
 {
     m_udp_application->SetStartTime(ns3::Seconds(0));
     m_udp_application->SetStopTime(sim_.stop_time());
@@ -111,6 +112,41 @@ auto base_station::set_decision_engine(std::shared_ptr<decision_engine> engine)
     m_decision_engine = engine;
 }
 
+auto base_station::set_queue_discipline(std::shared_ptr<queue_discipline> discipline) -> void
+{
+    m_queue_discipline = discipline ? std::move(discipline) : std::make_shared<fifo_discipline>();
+}
+
+auto base_station::get_queue_discipline() const -> std::shared_ptr<queue_discipline>
+{
+    return m_queue_discipline;
+}
+
+auto base_station::set_admission_controller(std::shared_ptr<admission_controller> controller) -> void
+{
+    m_admission_controller = std::move(controller);
+}
+
+auto base_station::get_admission_controller() const -> std::shared_ptr<admission_controller>
+{
+    return m_admission_controller;
+}
+
+auto base_station::schedule_retry(double delay) -> void
+{
+    auto when = ns3::Seconds(delay);
+    if (m_retry_event.IsRunning()) {
+        if (ns3::Simulator::GetDelayLeft(m_retry_event) <= when)
+            return;
+
+        m_retry_event.Cancel();
+    }
+
+    m_retry_event = okec::schedule(when, [this]() {
+        this->handle_next();
+    });
+}
+
 auto base_station::get_position() -> ns3::Vector
 {
     ns3::Ptr<ns3::MobilityModel> mobility = m_node->GetObject<ns3::MobilityModel>();
@@ -254,4 +290,19 @@ auto base_station_container::set_decision_engine(std::shared_ptr<decision_engine
     }
 }
 
+auto base_station_container::set_queue_discipline(std::shared_ptr<queue_discipline> discipline) -> void
+{
+    // 每个基站各自持有一份调度状态（如 backfill 的越过计数）和统计
+    for (pointer_t bs : m_base_stations) {
+        bs->set_queue_discipline(discipline ? discipline->clone() : nullptr);
+    }
+}
+
+auto base_station_container::set_admission_controller(std::shared_ptr<admission_controller> controller) -> void
+{
+    for (pointer_t bs : m_base_stations) {
+        bs->set_admission_controller(controller);
+    }
+}
+
 } // namespace okec
\ No newline at end of file
@@ -65,14 +65,14 @@ auto client_device::send(task t) -> void
     // 任务不能以 task 为单位发送，因为 task 可能会非常大，导致发送的数据断页，在目的端便无法恢复数据
     // 以 task_element 为单位发送则可以避免 task 大小可能会带来的问题
     // double launch_delay{ 1.0 };
-    for (auto&& item : t.elements_view()) {
+    for (auto&& item : t.release_elements()) {
         m_decision_engine->send(std::move(item), shared_from_this());
     }
 }
 
 auto client_device::async_send(task t) -> std::suspend_never
 {
-    for (auto&& item : t.elements_view()) {
+    for (auto&& item : t.release_elements()) {
         m_decision_engine->send(std::move(item), shared_from_this());
     }
 
@@ -81,7 +81,7 @@ auto client_device::async_send(task t) -> std::suspend_never
 
 auto client_device::async_read() -> response_awaiter
 {
-    return response_awaiter{sim_, okec::format("{:ip}", this->get_address())};
+    return response_awaiter{sim_, device_address{ this->get_address() }};
 }
 
 auto client_device::async_read(done_callback_t fn) -> void
@@ -91,9 +91,9 @@ auto client_device::async_read(done_callback_t fn) -> void
 
 auto client_device::when_done(response_type resp) -> void
 {
-    auto ip = okec::format("{:ip}", this->get_address());
-    if (sim_.is_valid(ip)) {
-        sim_.complete(ip, std::move(resp));
+    device_address client{ this->get_address() };
+    if (sim_.is_valid(client)) {
+        sim_.complete(client, std::move(resp));
     }
 
     if (this->has_done_callback()) {
@@ -127,11 +127,20 @@ auto client_device::set_decision_engine(std::shared_ptr<decision_engine> engine)
 auto client_device::set_request_handler(std::string_view msg_type, callback_type callback) -> void
 {
     m_udp_application->set_request_handler(msg_type, 
-        [callback, this](ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
+        [callback, this, is_response = msg_type == message_response](ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
             callback(this, packet, remote_address);
+            if (is_response && m_response_observer) {
+                message msg(packet);
+                m_response_observer(msg);
+            }
         });
 }
 
+auto client_device::set_response_observer(std::function<void(message&)> observer) -> void
+{
+    m_response_observer = std::move(observer);
+}
+
 auto client_device::dispatch(std::string_view msg_type, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) -> void
 {
     m_udp_application->dispatch(msg_type, packet, address);
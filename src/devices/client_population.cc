@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/devices/client_population.h>
+#include <okec/utils/log.h>
+#include <charconv>
+
+
+namespace okec
+{
+
+client_population::client_population(client_device_container& carriers, std::size_t users)
+    : carriers_(carriers.begin(), carriers.end())
+    , sent_(users)
+    , finished_(users)
+    , failed_(users)
+    , time_(users)
+{
+    attach();
+}
+
+client_population::client_population(std::vector<client_device_container>& carriers, std::size_t users)
+    : sent_(users)
+    , finished_(users)
+    , failed_(users)
+    , time_(users)
+{
+    for (auto& group : carriers)
+        carriers_.insert(carriers_.end(), group.begin(), group.end());
+    attach();
+}
+
+auto client_population::size() const -> std::size_t
+{
+    return sent_.size();
+}
+
+auto client_population::carrier_of(user_id user) const -> std::shared_ptr<client_device>
+{
+    return carriers_[user % carriers_.size()];
+}
+
+auto client_population::send(user_id user, task t) -> void
+{
+    if (user >= size() || carriers_.empty()) {
+        log::error("client_population: user {} does not exist", user);
+        return;
+    }
+
+    auto id = std::to_string(user);
+    for (auto&& item : t.elements_view())
+        item.set_header("user_id", id);
+
+    sent_[user] += static_cast<std::uint32_t>(t.size());
+    carrier_of(user)->send(std::move(t));
+}
+
+auto client_population::on_response(response_callback callback) -> void
+{
+    callback_ = std::move(callback);
+}
+
+auto client_population::sent(user_id user) const -> std::uint32_t
+{
+    return sent_[user];
+}
+
+auto client_population::finished(user_id user) const -> std::uint32_t
+{
+    return finished_[user];
+}
+
+auto client_population::failed(user_id user) const -> std::uint32_t
+{
+    return failed_[user];
+}
+
+auto client_population::average_time(user_id user) const -> double
+{
+    return finished_[user] ? time_[user] / finished_[user] : 0.0;
+}
+
+auto client_population::attach() -> void
+{
+    for (auto& carrier : carriers_)
+        carrier->set_response_observer([this](message& msg) { receive(msg); });
+}
+
+auto client_population::receive(message& msg) -> void
+{
+    auto text = msg.get_value("user_id");
+    user_id user{};
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), user);
+    if (ec != std::errc{} || user >= size())
+        return; // not sent through this population
+
+    if (msg.get_value("device_type") != "null") {
+        ++finished_[user];
+        auto processing_time = msg.get_value("processing_time");
+        double seconds{};
+        if (std::from_chars(processing_time.data(), processing_time.data() + processing_time.size(), seconds).ec == std::errc{})
+            time_[user] += seconds;
+    } else {
+        ++failed_[user];
+    }
+
+    if (callback_)
+        callback_(user, msg);
+}
+
+
+} // namespace okec
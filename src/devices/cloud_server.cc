@@ -67,6 +67,16 @@ auto cloud_server::install_resource(ns3::Ptr<resource> res) -> void
     res->install(m_node);
 }
 
+auto cloud_server::set_execution_model(std::shared_ptr<execution_model> model) -> void
+{
+    m_execution_model = std::move(model);
+}
+
+auto cloud_server::get_execution_model() const -> std::shared_ptr<execution_model>
+{
+    return m_execution_model;
+}
+
 auto cloud_server::set_position(double x, double y, double z) -> void
 {
     ns3::Ptr<ns3::MobilityModel> mobility = m_node->GetObject<ns3::MobilityModel>();
@@ -64,6 +64,16 @@ auto edge_device::install_resource(ns3::Ptr<resource> res) -> void
     res->install(m_node);
 }
 
+auto edge_device::set_execution_model(std::shared_ptr<execution_model> model) -> void
+{
+    m_execution_model = std::move(model);
+}
+
+auto edge_device::get_execution_model() const -> std::shared_ptr<execution_model>
+{
+    return m_execution_model;
+}
+
 auto edge_device::set_position(double x, double y, double z) -> void
 {
     ns3::Ptr<ns3::MobilityModel> mobility = m_node->GetObject<ns3::MobilityModel>();
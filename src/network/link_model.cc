@@ -0,0 +1,43 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/network/link_model.h>
+#include <ns3/mobility-model.h>
+
+
+namespace okec
+{
+
+bandwidth_link_model::bandwidth_link_model(double bandwidth, ns3::Time delay, ns3::Time jitter, double propagation_speed)
+    : bandwidth_{ bandwidth }
+    , delay_{ delay }
+    , jitter_{ jitter }
+    , speed_{ propagation_speed }
+    , random_{ ns3::CreateObject<ns3::UniformRandomVariable>() }
+{
+}
+
+auto bandwidth_link_model::latency(ns3::Ptr<ns3::Node> from, ns3::Ptr<ns3::Node> to, std::uint32_t bytes) -> ns3::Time
+{
+    double seconds = bytes * 8.0 / (bandwidth_ * 1000000.0);
+
+    auto from_mobility = from->GetObject<ns3::MobilityModel>();
+    auto to_mobility = to->GetObject<ns3::MobilityModel>();
+    if (from_mobility && to_mobility)
+        seconds += from_mobility->GetDistanceFrom(to_mobility) / speed_;
+
+    if (jitter_.IsStrictlyPositive())
+        seconds += random_->GetValue(0.0, jitter_.GetSeconds());
+
+    return delay_ + ns3::Seconds(seconds);
+}
+
+
+} // namespace okec
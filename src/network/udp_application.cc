@@ -9,10 +9,12 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <okec/common/task.h>
+#include <okec/network/link_model.h>
 #include <okec/network/udp_application.h>
 #include <okec/utils/format_helper.hpp>
 #include <okec/utils/log.h>
 #include <okec/utils/message_helper.hpp>
+#include <okec/utils/profiler.h>
 #include <ns3/arp-header.h>
 #include <ns3/csma-net-device.h>
 #include <ns3/ethernet-header.h>
@@ -21,6 +23,7 @@
 #include <ns3/simulator.h>
 #include <ns3/udp-header.h>
 #include <ns3/udp-socket.h>
+#include <utility>
 
 // #define PURPLE_CODE "\033[95m"
 // #define CYAN_CODE "\033[96m"
@@ -50,6 +53,8 @@ udp_application::udp_application()
 
 udp_application::~udp_application()
 {
+    for (auto key : m_endpoints)
+        endpoints().erase(key);
 }
 
 auto udp_application::GetTypeId() -> ns3::TypeId
@@ -72,22 +77,38 @@ auto udp_application::read_handler(ns3::Ptr<ns3::Socket> socket) -> void
     ns3::Address remote_address;
 
     while ((packet = socket->RecvFrom(remote_address))) {
-        auto content = packet_helper::to_string(packet);
-        log::debug("{:ip} has received a packet: \"{}\" size: {}", this->get_address(), content, content.size());
-        if (packet) {
-            auto msg_type = get_message_type(packet);
-            log::debug("{:ip} is processing [{}] message...", this->get_address(), msg_type);
-            auto dispatched = m_msg_handler.dispatch(msg_type, packet, remote_address);
-            NS_ASSERT_MSG(dispatched, "Invalid message type: " << msg_type);
-        }
+        receive(packet, remote_address);
     }
 }
 
+auto udp_application::receive(ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void
+{
+    auto content = packet_helper::to_string(packet);
+    log::debug("{:ip} has received a packet: \"{}\" size: {}", this->get_address(), content, content.size());
+    auto msg_type = get_message_type(packet);
+    log::debug("{:ip} is processing [{}] message...", this->get_address(), msg_type);
+    auto dispatched = m_msg_handler.dispatch(msg_type, packet, remote_address);
+    NS_ASSERT_MSG(dispatched, "Invalid message type: " << msg_type);
+}
+
 auto udp_application::write(ns3::Ptr<ns3::Packet> packet, ns3::Ipv4Address destination, uint16_t port) -> void
 {
     log::debug("{:ip}:{} ---> {:ip}:{}", this->get_address(), this->get_port(), ns3::Ipv4Address::ConvertFrom(destination), port);
     // NS_LOG_FUNCTION (this << packet << destination << port);
     
+    if (s_link_model) {
+        auto it = endpoints().find(device_address{ destination, port });
+        if (it != endpoints().end()) {
+            ns3::Ptr<udp_application> receiver{ it->second };
+            auto delay = s_link_model->latency(GetNode(), receiver->GetNode(), packet->GetSize());
+            ns3::Address from = ns3::InetSocketAddress(get_address(), m_port);
+            okec::schedule(delay, [receiver, packet = packet->Copy(), from]() {
+                receiver->receive(packet, from);
+            });
+            return;
+        }
+    }
+
     m_send_socket->Connect(ns3::InetSocketAddress(destination, port));
     m_send_socket->Send(packet);
 }
@@ -112,6 +133,16 @@ auto udp_application::dispatch(std::string_view msg_type, ns3::Ptr<ns3::Packet>
     m_msg_handler.dispatch(msg_type.data(), packet, address);
 }
 
+auto udp_application::set_link_model(std::shared_ptr<link_model> model) -> void
+{
+    s_link_model = std::move(model);
+}
+
+auto udp_application::get_link_model() -> std::shared_ptr<link_model>
+{
+    return s_link_model;
+}
+
 auto udp_application::StartApplication() -> void
 {
     ns3::TypeId tid = ns3::TypeId::LookupByName("ns3::UdpSocketFactory");
@@ -126,10 +157,23 @@ auto udp_application::StartApplication() -> void
     m_recv_socket->SetRecvCallback(MakeCallback(&udp_application::read_handler, this));
 
     m_send_socket = ns3::Socket::CreateSocket(GetNode(), tid);
+
+    // A message may be addressed to any interface of the node.
+    auto ipv4 = GetNode()->GetObject<ns3::Ipv4>();
+    for (uint32_t i = 1; i < ipv4->GetNInterfaces(); ++i) {
+        for (uint32_t j = 0; j < ipv4->GetNAddresses(i); ++j) {
+            device_address key{ ipv4->GetAddress(i, j).GetLocal(), m_port };
+            endpoints()[key] = this;
+            m_endpoints.push_back(key);
+        }
+    }
 }
 
 auto udp_application::StopApplication() -> void
 {
+    for (auto key : std::exchange(m_endpoints, {}))
+        endpoints().erase(key);
+
     m_recv_socket->Close();
     m_send_socket->Close();
 }
@@ -141,5 +185,11 @@ auto udp_application::get_socket_address(ns3::Ptr<ns3::Socket> socket) -> ns3::I
     return ipv4->GetAddress(1, 0).GetLocal();
 }
 
+auto udp_application::endpoints() -> std::unordered_map<device_address, udp_application*>&
+{
+    static std::unordered_map<device_address, udp_application*> registered;
+    return registered;
+}
+
 
-} // namespace simeg
\ No newline at end of file
+} // namespace simeg
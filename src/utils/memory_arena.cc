@@ -0,0 +1,158 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/utils/memory_arena.h>
+#include <okec/utils/format_helper.hpp>
+#include <okec/utils/sys.h>
+#include <algorithm>
+#include <new>
+
+
+namespace okec
+{
+
+namespace {
+
+// Every block starts with the arena it came from (null: the heap), so that it
+// can be returned without knowing which arena is current.
+struct alignas(16) block_header {
+    memory_arena* owner;
+    memory_subsystem subsystem;
+};
+
+static_assert(sizeof(block_header) == 16);
+
+thread_local memory_arena* current_arena{};
+thread_local memory_subsystem current_subsystem{ memory_subsystem::other };
+
+} // namespace
+
+
+auto memory_arena::open() -> memory_arena*
+{
+    auto arena = new memory_arena;
+    arena->previous_ = current_arena;
+    if (current_arena)
+        current_arena->next_ = arena;
+    current_arena = arena;
+    return arena;
+}
+
+auto memory_arena::close() -> void
+{
+    if (closed_)
+        return;
+
+    // Unlink from the chain of open arenas, which need not close in LIFO order
+    if (next_)
+        next_->previous_ = previous_;
+    if (previous_)
+        previous_->next_ = next_;
+    if (current_arena == this)
+        current_arena = previous_;
+    previous_ = next_ = nullptr;
+
+    closed_ = true;
+    if (blocks_ == 0)
+        delete this;
+}
+
+auto memory_arena::current() -> memory_arena*
+{
+    return current_arena;
+}
+
+auto memory_arena::allocate(std::size_t bytes) -> void*
+{
+    auto total = bytes + sizeof(block_header);
+    auto arena = current_arena;
+
+    void* block = arena ? arena->pool_.allocate(total, alignof(block_header)) : ::operator new(total);
+    auto header = ::new (block) block_header{ arena, current_subsystem };
+
+    if (arena) {
+        auto& u = arena->usage_[static_cast<std::size_t>(header->subsystem)];
+        u.allocated += bytes;
+        u.live += bytes;
+        u.peak = std::max(u.peak, u.live);
+        ++u.allocations;
+        ++arena->blocks_;
+    }
+
+    return header + 1;
+}
+
+auto memory_arena::deallocate(void* p, std::size_t bytes) noexcept -> void
+{
+    if (!p)
+        return;
+
+    auto header = static_cast<block_header*>(p) - 1;
+    if (auto owner = header->owner)
+        owner->release(header, bytes, header->subsystem);
+    else
+        ::operator delete(header);
+}
+
+auto memory_arena::release(void* block, std::size_t bytes, memory_subsystem subsystem) noexcept -> void
+{
+    pool_.deallocate(block, bytes + sizeof(block_header), alignof(block_header));
+    usage_[static_cast<std::size_t>(subsystem)].live -= bytes;
+
+    if (--blocks_ == 0 && closed_)
+        delete this;
+}
+
+auto memory_arena::stats(memory_subsystem subsystem) const -> const usage&
+{
+    return usage_[static_cast<std::size_t>(subsystem)];
+}
+
+auto memory_arena::print_stats() const -> void
+{
+    okec::print("{0:=^{1}}\n", " Memory arena ", okec::get_winsize().col);
+    okec::print("{:<16} {:>16} {:>14} {:>14} {:>14}\n", "subsystem", "allocations", "total KiB", "live KiB", "peak KiB");
+    for (std::size_t i = 0; i < usage_.size(); ++i) {
+        const auto& u = usage_[i];
+        okec::print("{:<16} {:>16} {:>14.1f} {:>14.1f} {:>14.1f}\n", name(static_cast<memory_subsystem>(i)),
+            u.allocations, u.allocated / 1024.0, u.live / 1024.0, u.peak / 1024.0);
+    }
+    okec::print("{0:=^{1}}\n", "", okec::get_winsize().col);
+}
+
+auto memory_arena::name(memory_subsystem subsystem) -> std::string_view
+{
+    switch (subsystem) {
+    case memory_subsystem::task:         return "task";
+    case memory_subsystem::message:      return "message";
+    case memory_subsystem::response:     return "response";
+    case memory_subsystem::device_cache: return "device_cache";
+    default:                             return "other";
+    }
+}
+
+memory_scope::memory_scope(memory_subsystem subsystem) noexcept
+    : previous_{ current_subsystem }
+{
+    current_subsystem = subsystem;
+}
+
+memory_scope::~memory_scope()
+{
+    current_subsystem = previous_;
+}
+
+auto memory_scope::current() noexcept -> memory_subsystem
+{
+    return current_subsystem;
+}
+
+
+} // namespace okec
@@ -0,0 +1,293 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/utils/metrics.h>
+#include <okec/common/simulator.h>
+#include <okec/utils/format_helper.hpp>
+#include <okec/utils/profiler.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+
+namespace okec
+{
+
+histogram::histogram(double lowest, double highest, unsigned sub_buckets)
+    : sub_buckets_{ std::max(sub_buckets, 1u) }
+{
+    std::frexp(lowest, &min_exponent_);
+    std::frexp(highest, &max_exponent_);
+    counts_.assign(static_cast<std::size_t>(max_exponent_ - min_exponent_ + 1) * sub_buckets_, 0);
+}
+
+auto histogram::index(double value) const -> std::size_t
+{
+    if (!(value > .0))
+        return 0;
+
+    int exponent{};
+    double mantissa = std::frexp(value, &exponent); // [0.5, 1)
+    if (exponent < min_exponent_)
+        return 0;
+    if (exponent > max_exponent_)
+        return counts_.size() - 1;
+
+    auto sub = static_cast<std::size_t>((mantissa - .5) * 2 * sub_buckets_);
+    return static_cast<std::size_t>(exponent - min_exponent_) * sub_buckets_ + std::min<std::size_t>(sub, sub_buckets_ - 1);
+}
+
+auto histogram::bucket_value(std::size_t index) const -> double
+{
+    // Middle of the bucket.
+    int exponent = min_exponent_ + static_cast<int>(index / sub_buckets_);
+    double mantissa = .5 + (index % sub_buckets_ + .5) / (2.0 * sub_buckets_);
+    return std::ldexp(mantissa, exponent);
+}
+
+auto histogram::quantile(double q) const -> double
+{
+    if (!count_)
+        return .0;
+
+    auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(q, .0, 1.0) * count_));
+    rank = std::max<std::uint64_t>(rank, 1);
+
+    std::uint64_t seen{};
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank)
+            return std::clamp(bucket_value(i), min_, max_);
+    }
+
+    return max_;
+}
+
+auto histogram::merge(const histogram& other) -> void
+{
+    if (other.counts_.size() != counts_.size())
+        return;
+
+    for (std::size_t i = 0; i < counts_.size(); ++i)
+        counts_[i] += other.counts_[i];
+
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+auto histogram::reset() -> void
+{
+    std::ranges::fill(counts_, 0);
+    count_ = 0;
+    sum_ = .0;
+    min_ = std::numeric_limits<double>::infinity();
+    max_ = -std::numeric_limits<double>::infinity();
+}
+
+
+auto metrics_registry::instance() -> metrics_registry&
+{
+    static metrics_registry registry;
+    return registry;
+}
+
+auto metrics_registry::enable(bool on) -> void
+{
+    enabled_ = on;
+}
+
+template <typename Metric>
+auto metrics_registry::find_or_create(table_type<Metric>& table, std::string_view name, metric_labels labels) -> Metric&
+{
+    key_view key{ name, labels.group, labels.device, labels.engine };
+    if (auto it = table.find(key); it != table.end())
+        return *it->second.metric;
+
+    auto [it, inserted] = table.emplace(
+        key_type{ name, labels.group, labels.device, labels.engine },
+        series<Metric>{
+            std::string{ name }, std::string{ labels.group }, std::string{ labels.device }, std::string{ labels.engine },
+            std::make_unique<Metric>()
+        });
+    return *it->second.metric;
+}
+
+template <typename Metric>
+auto metrics_registry::list(const table_type<Metric>& table) -> std::vector<const series<Metric>*>
+{
+    std::vector<const series<Metric>*> result;
+    result.reserve(table.size());
+    for (const auto& [key, s] : table)
+        result.push_back(&s);
+    return result;
+}
+
+auto metrics_registry::get_counter(std::string_view name, metric_labels labels) -> counter&
+{
+    return find_or_create(counters_, name, labels);
+}
+
+auto metrics_registry::get_gauge(std::string_view name, metric_labels labels) -> gauge&
+{
+    return find_or_create(gauges_, name, labels);
+}
+
+auto metrics_registry::get_histogram(std::string_view name, metric_labels labels) -> histogram&
+{
+    return find_or_create(histograms_, name, labels);
+}
+
+auto metrics_registry::counters() const -> std::vector<const series<counter>*>
+{
+    return list(counters_);
+}
+
+auto metrics_registry::gauges() const -> std::vector<const series<gauge>*>
+{
+    return list(gauges_);
+}
+
+auto metrics_registry::histograms() const -> std::vector<const series<histogram>*>
+{
+    return list(histograms_);
+}
+
+auto metrics_registry::merged_histogram(std::string_view name) const -> histogram
+{
+    histogram result;
+    for (const auto& [key, s] : histograms_) {
+        if (s.name == name)
+            result.merge(*s.metric);
+    }
+    return result;
+}
+
+auto metrics_registry::snapshot(const std::string& file, format fmt) const -> bool
+{
+    std::ofstream out{ file, std::ios::app };
+    if (!out)
+        return false;
+
+    double time = now::seconds();
+    auto labels = [](const auto& s) {
+        return okec::format("{},{},{}", s.group, s.device, s.engine);
+    };
+    auto json_labels = [](const auto& s) {
+        return okec::format(R"("group":"{}","device":"{}","engine":"{}")", s.group, s.device, s.engine);
+    };
+
+    if (fmt == format::csv && out.tellp() == 0)
+        out << "time,type,name,group,device,engine,value,count,mean,p50,p99,p999,max\n";
+
+    for (const auto& [key, s] : counters_) {
+        if (fmt == format::csv)
+            out << okec::format("{:.6f},counter,{},{},{},,,,,,\n", time, s.name, labels(s), s.metric->value());
+        else
+            out << okec::format(R"({{"time":{:.6f},"type":"counter","name":"{}",{},"value":{}}})", time, s.name, json_labels(s), s.metric->value()) << '\n';
+    }
+
+    for (const auto& [key, s] : gauges_) {
+        if (fmt == format::csv)
+            out << okec::format("{:.6f},gauge,{},{},{},,,,,,\n", time, s.name, labels(s), s.metric->value());
+        else
+            out << okec::format(R"({{"time":{:.6f},"type":"gauge","name":"{}",{},"value":{}}})", time, s.name, json_labels(s), s.metric->value()) << '\n';
+    }
+
+    for (const auto& [key, s] : histograms_) {
+        const auto& h = *s.metric;
+        if (fmt == format::csv)
+            out << okec::format("{:.6f},histogram,{},{},,{},{},{},{},{},{}\n", time, s.name, labels(s),
+                h.count(), h.mean(), h.quantile(.5), h.quantile(.99), h.quantile(.999), h.max());
+        else
+            out << okec::format(R"({{"time":{:.6f},"type":"histogram","name":"{}",{},"count":{},"mean":{},"p50":{},"p99":{},"p999":{},"max":{}}})",
+                time, s.name, json_labels(s), h.count(), h.mean(), h.quantile(.5), h.quantile(.99), h.quantile(.999), h.max()) << '\n';
+    }
+
+    return true;
+}
+
+auto metrics_registry::snapshot_every(ns3::Time interval, std::string file, format fmt) -> void
+{
+    okec::schedule(interval, [this, interval, file = std::move(file), fmt]() mutable {
+        this->snapshot(file, fmt);
+        this->snapshot_every(interval, std::move(file), fmt);
+    });
+}
+
+auto metrics_registry::reset() -> void
+{
+    counters_.clear();
+    gauges_.clear();
+    histograms_.clear();
+    ++generation_;
+}
+
+auto metrics_registry::generation() const -> std::size_t
+{
+    return generation_;
+}
+
+
+engine_metrics::engine_metrics(std::string_view engine)
+    : engine_{ engine }
+{
+}
+
+auto engine_metrics::sync() -> void
+{
+    auto generation = metrics_registry::instance().generation();
+    if (generation == generation_)
+        return;
+
+    dispatch_.clear();
+    completion_.clear();
+    queue_length_ = nullptr;
+    generation_ = generation;
+}
+
+auto engine_metrics::dispatch(std::string_view group) -> const dispatch_series&
+{
+    sync();
+    if (auto it = dispatch_.find(group); it != dispatch_.end())
+        return it->second;
+
+    auto& registry = metrics_registry::instance();
+    return dispatch_.emplace(std::string{ group }, dispatch_series{
+        &registry.get_histogram("wait_time", { .group = group, .engine = engine_ }),
+        &registry.get_counter("tasks_dispatched", { .group = group, .engine = engine_ })
+    }).first->second;
+}
+
+auto engine_metrics::completion(device_address device) -> const completion_series&
+{
+    sync();
+    if (auto it = completion_.find(device); it != completion_.end())
+        return it->second;
+
+    auto& registry = metrics_registry::instance();
+    auto label = device.ip_string();
+    return completion_.emplace(device, completion_series{
+        &registry.get_histogram("processing_time", { .device = label, .engine = engine_ }),
+        &registry.get_counter("tasks_completed", { .device = label, .engine = engine_ })
+    }).first->second;
+}
+
+auto engine_metrics::queue_length() -> gauge&
+{
+    sync();
+    if (!queue_length_)
+        queue_length_ = &metrics_registry::instance().get_gauge("queue_length", { .engine = engine_ });
+    return *queue_length_;
+}
+
+
+} // namespace okec
@@ -33,13 +33,6 @@ auto to_string(ns3::Ptr<ns3::Packet> packet) -> std::string
     return data;
 }
 
-auto to_json(ns3::Ptr<ns3::Packet> packet) -> json
-{
-    json j;
-    auto data = to_string(packet);
-    return j.accept(data) ? j.parse(data) : j;
-}
-
 
 } // namespace packet_helper
 } // namespace okec
\ No newline at end of file
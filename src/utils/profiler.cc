@@ -0,0 +1,165 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+//
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/utils/profiler.h>
+#include <okec/common/simulator.h>
+#include <okec/utils/format_helper.hpp>
+#include <okec/utils/sys.h>
+#include <algorithm>
+#include <fstream>
+
+
+namespace okec
+{
+
+profiler::scope::scope(std::string_view category, std::string_view name)
+    : active_{ profiler::enabled() }
+{
+    if (active_)
+        profiler::instance().push(okec::format("{}/{}", category, name));
+}
+
+profiler::scope::~scope()
+{
+    if (active_)
+        profiler::instance().pop();
+}
+
+auto profiler::instance() -> profiler&
+{
+    static profiler p;
+    return p;
+}
+
+auto profiler::enable(bool on) -> void
+{
+    enabled_ = on;
+}
+
+auto profiler::on_schedule(ns3::Time delay) -> void
+{
+    due_.push((now::time() + delay).GetSeconds());
+    sample_depth();
+}
+
+auto profiler::entries() const -> const std::map<std::string, entry>&
+{
+    return entries_;
+}
+
+auto profiler::queue_depth() const -> const std::vector<std::pair<double, std::size_t>>&
+{
+    return depth_;
+}
+
+auto profiler::push(std::string key) -> void
+{
+    sample_depth();
+    stack_.push_back(frame{ std::move(key), std::chrono::steady_clock::now() });
+}
+
+auto profiler::pop() -> void
+{
+    if (stack_.empty())
+        return;
+
+    auto current = std::move(stack_.back());
+    stack_.pop_back();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - current.start;
+    double seconds = elapsed.count();
+
+    auto& e = entries_[current.key];
+    ++e.count;
+    e.total_seconds += seconds;
+    e.max_seconds = std::max(e.max_seconds, seconds);
+
+    std::string stack_key;
+    for (const auto& f : stack_) {
+        stack_key += f.key;
+        stack_key += ';';
+    }
+    stack_key += current.key;
+    folded_[stack_key] += std::max(.0, seconds - current.child_seconds);
+
+    if (!stack_.empty())
+        stack_.back().child_seconds += seconds;
+}
+
+auto profiler::sample_depth() -> void
+{
+    double current = now::seconds();
+    while (!due_.empty() && due_.top() < current)
+        due_.pop();
+
+    // One sample per simulated instant is enough for a depth-over-time plot.
+    if (!depth_.empty() && depth_.back().first == current)
+        depth_.back().second = due_.size();
+    else
+        depth_.emplace_back(current, due_.size());
+}
+
+auto profiler::print_table() const -> void
+{
+    std::vector<std::pair<std::string, entry>> rows(entries_.begin(), entries_.end());
+    std::ranges::sort(rows, [](const auto& lhs, const auto& rhs) {
+        return lhs.second.total_seconds > rhs.second.total_seconds;
+    });
+
+    std::size_t max_depth{};
+    for (const auto& [time, depth] : depth_)
+        max_depth = std::max(max_depth, depth);
+
+    okec::print("{0:=^{1}}\n", " Profiler ", okec::get_winsize().col);
+    okec::print("{:<60} {:>10} {:>14} {:>12} {:>12}\n", "handler", "count", "total ms", "avg us", "max us");
+    for (const auto& [key, e] : rows) {
+        okec::print("{:<60} {:>10} {:>14.3f} {:>12.3f} {:>12.3f}\n", key, e.count,
+            e.total_seconds * 1e3, e.total_seconds / e.count * 1e6, e.max_seconds * 1e6);
+    }
+    okec::print("peak OKEC event queue depth: {} ({} samples)\n", max_depth, depth_.size());
+    okec::print("{0:=^{1}}\n", "", okec::get_winsize().col);
+}
+
+auto profiler::write_folded(const std::string& file) const -> bool
+{
+    std::ofstream out{ file };
+    if (!out)
+        return false;
+
+    for (const auto& [stack, seconds] : folded_) {
+        // Flame graphs take integer sample counts; microseconds keep short handlers visible.
+        auto micros = static_cast<long long>(seconds * 1e6 + .5);
+        if (micros > 0)
+            out << stack << ' ' << micros << '\n';
+    }
+
+    return true;
+}
+
+auto profiler::reset() -> void
+{
+    entries_.clear();
+    folded_.clear();
+    stack_.clear();
+    due_ = {};
+    depth_.clear();
+}
+
+auto callsite_name(const std::source_location& location) -> std::string
+{
+    std::string_view file{ location.file_name() };
+    if (auto pos = file.find_last_of("/\\"); pos != std::string_view::npos)
+        file.remove_prefix(pos + 1);
+
+    return okec::format("{}:{} ({})", file, location.line(), location.function_name());
+}
+
+
+} // namespace okec